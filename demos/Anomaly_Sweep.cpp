@@ -0,0 +1,278 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include <util/ThreadPool.h>
+#include <mnist/AnomalyTrace.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Evenly spaced values from min to max
+struct SweepRange {
+    float _min, _max;
+    int _count;
+
+    SweepRange(float min, float max, int count)
+        : _min(min), _max(max), _count(count)
+    {}
+
+    float getValue(int i) const {
+        return _count > 1 ? _min + (_max - _min) * i / (_count - 1) : _min;
+    }
+};
+
+// Command line options
+struct Options {
+    std::string _traceFileName;
+
+    SweepRange _sensitivity;
+    SweepRange _averageDecay;
+
+    // Sweep adaptive thresholds (standard deviations below the mean training score) instead of sensitivity
+    bool _sweepDeviations;
+    SweepRange _deviations;
+
+    int _minSuccessors;
+    int _maxSuccessors;
+
+    int _numThreads;
+
+    // Every grid point as CSV (empty for none)
+    std::string _csvFileName;
+
+    // Best settings shown
+    int _top;
+
+    Options()
+        : _sensitivity(1.0f, 2.0f, 101), _averageDecay(0.0f, 0.99f, 12), _sweepDeviations(false), _deviations(0.5f, 5.0f, 91),
+        _minSuccessors(1), _maxSuccessors(12),
+        _numThreads(std::max(1, static_cast<int>(std::thread::hardware_concurrency()))), _top(10)
+    {}
+};
+
+bool parseOptions(int argc, char *argv[], Options &options) {
+    if (argc < 2)
+        return false;
+
+    options._traceFileName = argv[1];
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg(argv[i]);
+
+        // std::stoi and std::stof throw on values that are not numbers or out of range
+        try {
+            if (arg == "--sensitivity" && i + 3 < argc) {
+                options._sensitivity._min = std::stof(argv[++i]);
+                options._sensitivity._max = std::stof(argv[++i]);
+                options._sensitivity._count = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (arg == "--decay" && i + 3 < argc) {
+                options._averageDecay._min = std::stof(argv[++i]);
+                options._averageDecay._max = std::stof(argv[++i]);
+                options._averageDecay._count = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (arg == "--deviations" && i + 3 < argc) {
+                options._sweepDeviations = true;
+                options._deviations._min = std::stof(argv[++i]);
+                options._deviations._max = std::stof(argv[++i]);
+                options._deviations._count = std::max(1, std::stoi(argv[++i]));
+            }
+            else if (arg == "--successors" && i + 2 < argc) {
+                options._minSuccessors = std::max(1, std::stoi(argv[++i]));
+                options._maxSuccessors = std::max(options._minSuccessors, std::stoi(argv[++i]));
+            }
+            else if (arg == "--threads" && i + 1 < argc)
+                options._numThreads = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--csv" && i + 1 < argc)
+                options._csvFileName = argv[++i];
+            else if (arg == "--top" && i + 1 < argc)
+                options._top = std::max(1, std::stoi(argv[++i]));
+            else
+                return false;
+        }
+        catch (const std::logic_error &) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Scores of one grid point
+struct SweepResult {
+    mnist::DetectorParams _params;
+
+    float _precision;
+    float _recall;
+    float _f1;
+
+    // Mean detection latency in digits
+    float _latency;
+
+    int _numTruePositives;
+    int _numFalsePositives;
+};
+
+SweepResult score(const mnist::AnomalyTraceReader &trace, const mnist::DetectorParams &params, mnist::AnomalyEvaluator &evaluator) {
+    mnist::replayTrace(trace, params, evaluator);
+
+    SweepResult result;
+    result._params = params;
+    result._precision = evaluator.getPrecision();
+    result._recall = evaluator.getRecall();
+    result._f1 = result._precision + result._recall > 0.0f ? 2.0f * result._precision * result._recall / (result._precision + result._recall) : 0.0f;
+    result._latency = evaluator.getMeanLatency();
+    result._numTruePositives = evaluator.getNumTruePositives();
+    result._numFalsePositives = evaluator.getNumFalsePositives();
+
+    return result;
+}
+
+void printResult(const SweepResult &result, bool deviations) {
+    std::cout << std::fixed << std::setprecision(3)
+        << std::setw(12) << (deviations ? result._params._deviations : result._params._sensitivity) << std::setw(8) << result._params._averageDecay << std::setw(12) << result._params._numSuccessorsRequired
+        << std::setw(10) << result._precision << std::setw(8) << result._recall << std::setw(8) << result._f1 << std::setw(10) << result._latency
+        << std::setw(6) << result._numTruePositives << std::setw(6) << result._numFalsePositives << std::defaultfloat << std::endl;
+}
+
+// Replay the detector of MNIST_Anomaly_Detection over a recorded trace (--trace) for every combination
+// of a grid of settings, in parallel, and rank them by F1 score. With --deviations the threshold axis
+// is the adaptive one, standard deviations below the mean training score
+int main(int argc, char *argv[]) {
+    Options options;
+
+    if (!parseOptions(argc, argv, options)) {
+        std::cout << "Usage: " << argv[0] << " trace.bin [--sensitivity min max count] [--decay min max count] [--successors min max]" << std::endl <<
+            "    [--deviations min max count] [--threads count] [--csv results.csv] [--top count]" << std::endl;
+        return 1;
+    }
+
+    mnist::AnomalyTraceReader trace;
+
+    if (!trace.open(options._traceFileName)) {
+        std::cerr << "Could not read anomaly trace: " << options._traceFileName << std::endl;
+        return 1;
+    }
+
+    size_t numTrainSteps = 0;
+
+    for (size_t i = 0; i < trace.getNumRecords(); i++)
+        if (trace.getRecord(i)._flags & mnist::AnomalyTraceRecord::_train)
+            numTrainSteps++;
+
+    std::cout << "Trace: " << numTrainSteps << " training steps, " << (trace.getNumRecords() - numTrainSteps) << " detection steps" << std::endl;
+
+    // Grid, successors fastest
+    const int numSuccessors = options._maxSuccessors - options._minSuccessors + 1;
+
+    const SweepRange &thresholds = options._sweepDeviations ? options._deviations : options._sensitivity;
+
+    std::vector<SweepResult> results(options._averageDecay._count * thresholds._count * numSuccessors);
+
+    std::chrono::high_resolution_clock::time_point sweepStart = std::chrono::high_resolution_clock::now();
+
+    {
+        util::ThreadPool pool;
+        pool.create(options._numThreads);
+
+        // One task per decay and threshold, each with its own evaluator
+        for (int d = 0; d < options._averageDecay._count; d++)
+            for (int s = 0; s < thresholds._count; s++) {
+                SweepResult* taskResults = results.data() + (s + d * thresholds._count) * numSuccessors;
+
+                pool.push([&options, &trace, &thresholds, taskResults, d, s, numSuccessors]() {
+                    mnist::AnomalyEvaluator evaluator;
+                    evaluator.create(false);
+
+                    // Variance decay as recorded, it is not swept
+                    mnist::DetectorParams params = trace.getRecordedParams();
+
+                    if (options._sweepDeviations)
+                        params._deviations = thresholds.getValue(s);
+                    else {
+                        params._sensitivity = thresholds.getValue(s);
+                        params._deviations = 0.0f;
+                    }
+
+                    params._averageDecay = options._averageDecay.getValue(d);
+
+                    for (int n = 0; n < numSuccessors; n++) {
+                        params._numSuccessorsRequired = options._minSuccessors + n;
+
+                        taskResults[n] = score(trace, params, evaluator);
+                    }
+                });
+            }
+
+        pool.wait();
+    }
+
+    std::chrono::duration<float> sweepSeconds = std::chrono::high_resolution_clock::now() - sweepStart;
+
+    std::cout << "Swept " << results.size() << " settings on " << options._numThreads << " threads in " << sweepSeconds.count() << " s ("
+        << (results.size() * trace.getNumRecords()) / std::max(0.001f, sweepSeconds.count()) << " steps/s)" << std::endl << std::endl;
+
+    std::cout << std::setw(12) << (options._sweepDeviations ? "Deviations" : "Sensitivity") << std::setw(8) << "Decay" << std::setw(12) << "Successors"
+        << std::setw(10) << "Precision" << std::setw(8) << "Recall" << std::setw(8) << "F1" << std::setw(10) << "Latency"
+        << std::setw(6) << "TP" << std::setw(6) << "FP" << std::endl;
+
+    // The settings the trace was recorded with, matching the recording run's report
+    {
+        mnist::AnomalyEvaluator evaluator;
+        evaluator.create(false);
+
+        std::cout << "Recorded:" << std::endl;
+
+        printResult(score(trace, trace.getRecordedParams(), evaluator), options._sweepDeviations);
+    }
+
+    // Best F1 first, lower latency breaking ties
+    std::vector<int> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+
+    std::sort(order.begin(), order.end(), [&results](int a, int b) {
+        if (results[a]._f1 != results[b]._f1)
+            return results[a]._f1 > results[b]._f1;
+
+        return results[a]._latency < results[b]._latency;
+    });
+
+    std::cout << "Best:" << std::endl;
+
+    for (int i = 0; i < std::min(options._top, static_cast<int>(order.size())); i++)
+        printResult(results[order[i]], options._sweepDeviations);
+
+    if (!options._csvFileName.empty()) {
+        std::FILE* out = std::fopen(options._csvFileName.c_str(), "w");
+
+        if (out == nullptr) {
+            std::cerr << "Could not open output: " << options._csvFileName << std::endl;
+            return 1;
+        }
+
+        std::fprintf(out, "sensitivity,deviations,average_decay,successors,precision,recall,f1,latency_digits,true_positives,false_positives\n");
+
+        for (const SweepResult &result : results)
+            std::fprintf(out, "%.9g,%.9g,%.9g,%d,%.9g,%.9g,%.9g,%.9g,%d,%d\n", result._params._sensitivity, result._params._deviations, result._params._averageDecay,
+                result._params._numSuccessorsRequired, result._precision, result._recall, result._f1, result._latency,
+                result._numTruePositives, result._numFalsePositives);
+
+        std::fclose(out);
+    }
+
+    return 0;
+}
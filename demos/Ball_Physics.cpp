@@ -17,6 +17,8 @@
 #include <neo/Architect.h>
 #include <neo/Hierarchy.h>
 
+#include <util/InputStaging.h>
+
 int main() {
     std::mt19937 generator(time(nullptr));
 
@@ -47,9 +49,11 @@ int main() {
 
     std::shared_ptr<ogmaneo::Hierarchy> h = arch.generateHierarchy();
 
-    // Fields for inputs and predictions
-    ogmaneo::ValueField2D inputField(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y));
-    ogmaneo::ValueField2D predField(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y));
+    // Persistent input field, predictions are read in place from the hierarchy
+    util::InputStaging staging;
+    staging.create(h, { ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y) });
+
+    ogmaneo::ValueField2D &inputField = staging.getInput(0);
 
     // ----------------------------- Physics ------------------------------
 
@@ -254,21 +258,17 @@ int main() {
 
         // Feed first 5 frames from image, even when generating ("seed" sequence)
         if (simFrame > 5 && genMode) {
-            inputField = predField;
+            staging.feedBackPredictions();
 
-            std::vector<ogmaneo::ValueField2D> inputVector = { inputField };
-
-            h->activate(inputVector);        
+            staging.activate();
         }
         else {
-            std::vector<ogmaneo::ValueField2D> inputVector = { inputField };
-
-            h->activate(inputVector);
-            h->learn(inputVector);
+            staging.activate();
+            staging.learn();
         }
 
         // Retrieve prediction
-        predField = h->getPredictions().front();
+        const ogmaneo::ValueField2D &predField = staging.getPrediction(0);
 
         // Display prediction
         sf::Image img;
@@ -12,6 +12,8 @@
 #include <neo/Architect.h>
 #include <neo/Hierarchy.h>
 
+#include <util/InputStaging.h>
+
 #include <time.h>
 #include <iostream>
 #include <random>
@@ -55,14 +57,13 @@ int main() {
     // Generate the hierarchy
     std::shared_ptr<ogmaneo::Hierarchy> h = arch.generateHierarchy();
 
-    // Layers for IO (input and prediction)
-    ogmaneo::ValueField2D inputFieldR(ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), 0.0f);
-    ogmaneo::ValueField2D inputFieldG(ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), 0.0f);
-    ogmaneo::ValueField2D inputFieldB(ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), 0.0f);
+    // Layers for IO (input and prediction), predictions are read in place from the hierarchy
+    util::InputStaging staging;
+    staging.create(h, { ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y) });
 
-    ogmaneo::ValueField2D predFieldR(ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), 0.0f);
-    ogmaneo::ValueField2D predFieldG(ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), 0.0f);
-    ogmaneo::ValueField2D predFieldB(ogmaneo::Vec2i(rt.getSize().x, rt.getSize().y), 0.0f);
+    ogmaneo::ValueField2D &inputFieldR = staging.getInput(0);
+    ogmaneo::ValueField2D &inputFieldG = staging.getInput(1);
+    ogmaneo::ValueField2D &inputFieldB = staging.getInput(2);
   
     // Image shown containing previously generated pixels
     sf::Image showImg;
@@ -111,10 +112,8 @@ int main() {
                 }
 
             // Step the hierarchy
-            std::vector<ogmaneo::ValueField2D> inputVector = { inputFieldR, inputFieldG, inputFieldB };
-
-            h->activate(inputVector);
-            h->learn(inputVector);
+            staging.activate();
+            staging.learn();
         }
     }
 
@@ -151,9 +150,9 @@ int main() {
             quit = true;
 
         // Get predictions from last frame
-        predFieldR = h->getPredictions()[0];
-        predFieldG = h->getPredictions()[1];
-        predFieldB = h->getPredictions()[2];
+        const ogmaneo::ValueField2D &predFieldR = staging.getPrediction(0);
+        const ogmaneo::ValueField2D &predFieldG = staging.getPrediction(1);
+        const ogmaneo::ValueField2D &predFieldB = staging.getPrediction(2);
 
         // Shift results
         for (int x = 0; x < rt.getSize().x - 1; x++) {
@@ -224,9 +223,8 @@ int main() {
         }
 
         // Generate level
-        std::vector<ogmaneo::ValueField2D> inputVector = { predFieldR, predFieldG, predFieldB };
-
-        h->activate(inputVector);
+        staging.feedBackPredictions();
+        staging.activate();
 
         // Create texture from show image
         sf::Texture tex;
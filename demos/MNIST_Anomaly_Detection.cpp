@@ -11,427 +11,447 @@
 #include <neo/SparseFeaturesChunk.h>
 
 #include <vis/Plot.h>
+#include <util/InputStaging.h>
+#include <mnist/MnistDataset.h>
+#include <mnist/ClassIndex.h>
+#include <mnist/DigitStream.h>
+#include <mnist/DigitCompositor.h>
+#include <mnist/AnomalyDetector.h>
+#include <mnist/AnomalyEvaluator.h>
+#include <mnist/AnomalyTrace.h>
 
 #include <time.h>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
 #include <random>
 #include <algorithm>
+#include <stdexcept>
 
 using namespace ogmaneo;
 
-// Temporary MNIST image buffer
-struct Image {
-    std::vector<sf::Uint8> _intensities;
-};
+// Command line options
+struct Options {
+    // Train and evaluate without a window, reporting to the terminal
+    bool _headless;
 
-// MNIST image loading
-void loadMNISTimage(std::ifstream &fromFile, int index, Image &img) {
-    const int headerSize = 16;
-    const int imageSize = 28 * 28;
+    // Steps to train before switching to detection (0 to wait for R, headless runs default to 20000)
+    int _trainSteps;
 
-    fromFile.seekg(headerSize + index * imageSize);
+    // Digits streamed through detection in a headless run
+    int _evalDigits;
 
-    if (img._intensities.size() != 28 * 28)
-        img._intensities.resize(28 * 28);
+    // Digit sequence seed (-1 for the time, headless runs default to 1)
+    int _seed;
 
-    fromFile.read(reinterpret_cast<char*>(img._intensities.data()), 28 * 28);
-}
+    // ROC curve of a headless run as CSV (empty for none)
+    std::string _rocFileName;
 
-// MNIST label loading
-int loadMNISTlabel(std::ifstream &fromFile, int index) {
-    const int headerSize = 8;
+    // Raw per step scores for Anomaly_Sweep (empty for none)
+    std::string _traceFileName;
 
-    fromFile.seekg(headerSize + index * 1);
+    // Trained hierarchy (and its .detector thresholds) to write after headless training (empty for none)
+    std::string _saveFileName;
 
-    char label;
+    // Trained hierarchy to evaluate, training further only with --train-steps (empty for none)
+    std::string _loadFileName;
 
-    fromFile.read(&label, 1);
+    // Flag steps scoring this many standard deviations below the mean training score instead of
+    // using the fixed sensitivity (0 keeps the default or loaded setting)
+    float _deviations;
+
+    Options()
+        : _headless(false), _trainSteps(0), _evalDigits(2000), _seed(-1), _deviations(0.0f)
+    {}
+};
 
-    return static_cast<int>(label);
+bool parseOptions(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+
+        // std::stoi and std::stof throw on values that are not numbers or out of range
+        try {
+            if (arg == "--headless")
+                options._headless = true;
+            else if (arg == "--train-steps" && i + 1 < argc)
+                options._trainSteps = std::stoi(argv[++i]);
+            else if (arg == "--eval-digits" && i + 1 < argc)
+                options._evalDigits = std::stoi(argv[++i]);
+            else if (arg == "--seed" && i + 1 < argc)
+                options._seed = std::stoi(argv[++i]);
+            else if (arg == "--roc" && i + 1 < argc)
+                options._rocFileName = argv[++i];
+            else if (arg == "--trace" && i + 1 < argc)
+                options._traceFileName = argv[++i];
+            else if (arg == "--save" && i + 1 < argc)
+                options._saveFileName = argv[++i];
+            else if (arg == "--load" && i + 1 < argc)
+                options._loadFileName = argv[++i];
+            else if (arg == "--deviations" && i + 1 < argc)
+                options._deviations = std::stof(argv[++i]);
+            else
+                return false;
+        }
+        catch (const std::logic_error &) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
 }
 
-int main() {
-    const float moveSpeed = 1.0f; // Speed digits move across the screen
-    const float spacing = 28.0f; // Spacing between digits
-    const int targetLabel = 3; // Label of non-anomalous class
-    const int totalMain = 5; // Amount of target (main) digits to load
-    const int totalAnomalous = 2000; // Amount of anomalous digits to load
-    const float anomalyRate = 0.1f; // Ratio of time which anomalies randomly appear
-    const int imgPoolSize = 20; // Offscreen digit pool buffer size
-    const float sensitivity = 1.35f; // Sensitivity to anomalies
-    const float averageDecay = 0.01f; // Average activity decay
-    const int numSuccessorsRequired = 4; // Number of successors before an anomaly is signalled
-    const float spinRate = 5.0f; // How fast the digits spin
-    const int okRange = 1; // Approximate range (in digits) where an anomaly flag can be compared to the actual anomaly outcome
-
-    // Creat a random number generator
-    std::mt19937 generator(time(nullptr));
+// Outcome of one simulation step
+struct StepResult {
+    // Negative mean squared prediction error
+    float _score;
 
-    // --------------------------- Create the Hierarchy ---------------------------
+    // Whether an anomalous digit was within range of the center
+    bool _anomalyInRange;
 
-    // Bottom input width and height
-    int bottomWidth = 28;
-    int bottomHeight = 28;
+    // Whether a new digit entered the stream
+    bool _newDigit;
+};
 
-    std::shared_ptr<ogmaneo::Resources> res = std::make_shared<ogmaneo::Resources>();
+int main(int argc, char *argv[]) {
+    Options options;
 
-    res->create(ogmaneo::ComputeSystem::_gpu);
+    if (!parseOptions(argc, argv, options)) {
+        std::cout << "Usage: " << argv[0] << " [--headless] [--train-steps steps] [--eval-digits digits] [--seed seed] [--roc roc.csv] [--trace trace.bin]" << std::endl <<
+            "    [--save hierarchy.ohr] [--load hierarchy.ohr] [--deviations k]" << std::endl;
+        return 1;
+    }
 
-    ogmaneo::Architect arch;
-    arch.initialize(1234, res);
+    // Loaded hierarchies are only evaluated
+    if (!options._loadFileName.empty())
+        options._headless = true;
 
-    // 1 input layer
-    arch.addInputLayer(ogmaneo::Vec2i(bottomWidth, bottomHeight));
+    if (options._headless) {
+        if (options._trainSteps <= 0 && options._loadFileName.empty())
+            options._trainSteps = 20000;
 
-    // 8 layers using chunk encoders
-    for (int l = 0; l < 6; l++)
-        arch.addHigherLayer(ogmaneo::Vec2i(96, 96), l == 0 ? ogmaneo::_distance : ogmaneo::_chunk);
+        if (options._seed < 0)
+            options._seed = 1;
+    }
 
-    // Generate the hierarchy
-    std::shared_ptr<ogmaneo::Hierarchy> h = arch.generateHierarchy();
+    // Digit stream settings
+    mnist::DigitStreamParams streamParams;
+    streamParams._moveSpeed = 1.0f; // Speed digits move across the screen
+    streamParams._spacing = 28.0f; // Spacing between digits
+    streamParams._targetLabel = 3; // Label of non-anomalous class
+    streamParams._totalMain = 5; // Amount of target (main) digits to load
+    streamParams._totalAnomalous = 2000; // Amount of anomalous digits to load
+    streamParams._anomalyRate = 0.1f; // Ratio of time which anomalies randomly appear
+    streamParams._poolSize = 20; // Offscreen digit pool buffer size
+    streamParams._spinRate = 5.0f; // How fast the digits spin
+    streamParams._okRange = 1; // Approximate range (in digits) where an anomaly flag can be compared to the actual anomaly outcome
+
+    // Detection thresholds
+    mnist::DetectorParams detectorParams;
+    detectorParams._sensitivity = 1.35f; // Sensitivity to anomalies
+    detectorParams._averageDecay = 0.01f; // Average activity decay
+    detectorParams._numSuccessorsRequired = 4; // Number of successors before an anomaly is signalled
+
+    // Digit sequence seed
+    unsigned int seed = options._seed >= 0 ? static_cast<unsigned int>(options._seed) : static_cast<unsigned int>(time(nullptr));
 
-    // Input and prediction fields
-    ogmaneo::ValueField2D inputField(ogmaneo::Vec2i(bottomWidth, bottomHeight));
-    ogmaneo::ValueField2D predField(ogmaneo::Vec2i(bottomWidth, bottomHeight));
+    // Bottom input width and height
+    int bottomWidth = 28;
+    int bottomHeight = 28;
 
-    // --------------------------- Create the Windows ---------------------------
+    // --------------------------- Digit rendering ---------------------------
 
-    sf::RenderWindow window;
+    // Load MNIST, mapped (or inflated from .gz) once, digits are read in place
+    mnist::MnistDataset mnistData;
 
-    window.create(sf::VideoMode(1024, 512), "MNIST Anomaly Detection");
+    if (!mnistData.open("resources"))
+        return 1;
 
-    // --------------------------- Plot ---------------------------
+    if (mnistData.getWidth() != bottomWidth || mnistData.getHeight() != bottomHeight) {
+        std::cerr << "Expected 28x28 MNIST digits, found " << mnistData.getWidth() << "x" << mnistData.getHeight() << std::endl;
 
-    vis::Plot plot;
-    plot._curves.resize(1);
-    plot._curves[0]._shadow = 0.1f;	
+        return 1;
+    }
 
-    plot._curves[0]._name = "Prediction Error";
+    // Digits are composited on the CPU straight into the input field
+    mnist::DigitCompositor compositor;
+    compositor.create(bottomWidth, bottomHeight);
 
-    const int overSizeMult = 6; // How many times the graph should extent past what is visible on-screen in terms of anomaly times
+    // Digits of each class, from the sidecar index (built in one pass over the labels on the first run)
+    mnist::ClassIndex classIndex;
+    classIndex.loadOrBuild(mnistData);
 
-    plot._curves[0]._points.resize(bottomWidth * overSizeMult);
+    // --------------------------- Create the Hierarchy ---------------------------
 
-    // Initialize
-    for (int i = 0; i < plot._curves[0]._points.size(); i++) {
-        plot._curves[0]._points[i]._position = sf::Vector2f(i, 0.0f);
-        plot._curves[0]._points[i]._color = sf::Color::Red;
-    }
+    auto addLayers = [&](ogmaneo::Architect &arch) {
+        // 1 input layer
+        arch.addInputLayer(ogmaneo::Vec2i(bottomWidth, bottomHeight));
 
-    // Render target for the plot
-    sf::RenderTexture plotRT;
-    plotRT.create(window.getSize().y, window.getSize().y, false);
+        // 8 layers using chunk encoders
+        for (int l = 0; l < 6; l++)
+            arch.addHigherLayer(ogmaneo::Vec2i(96, 96), l == 0 ? ogmaneo::_distance : ogmaneo::_chunk);
+    };
 
-    // Resources for the plot
-    sf::Texture lineGradient;
-    lineGradient.loadFromFile("resources/lineGradient.png");
+    // Evaluation summary, and the ROC curve if requested
+    auto report = [&](const mnist::AnomalyEvaluator &evaluator) {
+        evaluator.writeReport(std::cout);
 
-    sf::Font tickFont;
-    
-#ifdef _WINDOWS
-    tickFont.loadFromFile("C:/Windows/Fonts/Arial.ttf");
-#else
-#ifdef __APPLE__
-    tickFont.loadFromFile("/Library/Fonts/Courier New.ttf");
-#else
-    tickFont.loadFromFile("/usr/share/fonts/truetype/freefont/FreeMono.ttf");
-#endif
-#endif
+        if (!options._rocFileName.empty()) {
+            std::ofstream rocFile(options._rocFileName);
 
-    // Uniform random in [0, 1]
-    std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+            if (!rocFile.is_open()) {
+                std::cerr << "Could not write " << options._rocFileName << std::endl;
 
-    // --------------------------- Digit rendering ---------------------------
+                return false;
+            }
 
-    // Load MNIST
-#if defined(_WINDOWS) || defined(__APPLE__)
-    std::ifstream fromImageFile("resources/train-images.idx3-ubyte", std::ios::binary | std::ios::in);
-#else
-    std::ifstream fromImageFile("resources/train-images-idx3-ubyte", std::ios::binary | std::ios::in);
-#endif
-    if (!fromImageFile.is_open()) {
-        std::cerr << "Could not open train-images.idx3-ubyte!" << std::endl;
+            evaluator.writeRoc(rocFile);
+        }
+
+        return true;
+    };
+
+    // Trained average score and thresholds saved with the hierarchy
+    mnist::AnomalyDetector detector;
+    detector.create(detectorParams);
+
+    if (!options._loadFileName.empty() && !detector.load(mnist::AnomalyDetector::getDetectorFileName(options._loadFileName))) {
+        std::cerr << "Could not read " << mnist::AnomalyDetector::getDetectorFileName(options._loadFileName) << std::endl;
 
         return 1;
     }
 
-#if defined(_WINDOWS) || defined(__APPLE__)
-    std::ifstream fromLabelFile("resources/train-labels.idx1-ubyte", std::ios::binary | std::ios::in);
-#else
-    std::ifstream fromLabelFile("resources/train-labels-idx1-ubyte", std::ios::binary | std::ios::in);
-#endif
-    if (!fromLabelFile.is_open()) {
-        std::cerr << "Could not open train-labels.idx1-ubyte!" << std::endl;
+    if (options._deviations > 0.0f) {
+        mnist::DetectorParams params = detector.getParams();
+        params._deviations = options._deviations;
 
-        return 1;
+        detector.setParams(params);
     }
 
-    // Main render target
-    sf::RenderTexture rt;
+    std::shared_ptr<ogmaneo::Resources> res = std::make_shared<ogmaneo::Resources>();
 
-    rt.create(bottomWidth, bottomHeight);
+    res->create(ogmaneo::ComputeSystem::_gpu);
 
-    // Positioning values
-    const float boundingSize = (bottomWidth - 28) / 2;
-    const float center = bottomWidth / 2;
-    const float minimum = center - boundingSize;
-    const float maximum = center + boundingSize;
+    ogmaneo::Architect arch;
+    arch.initialize(1234, res);
 
-    std::vector<int> mainIndices; // Indicies of main (target) class digits
-    std::vector<int> anomalousIndices; // Indicies of anomalous class digits
+    addLayers(arch);
 
-    // Find indices for both main and anomalous
-    int index = 0;
+    // Generate the hierarchy
+    std::shared_ptr<ogmaneo::Hierarchy> h = arch.generateHierarchy();
 
-    while (mainIndices.size() < totalMain || anomalousIndices.size() < totalAnomalous) {
-        int label = loadMNISTlabel(fromLabelFile, index);
+    if (!options._loadFileName.empty()) {
+        // Hierarchy::load cannot report a missing file
+        if (!std::ifstream(options._loadFileName).good()) {
+            std::cerr << "Could not open hierarchy " << options._loadFileName << std::endl;
 
-        if (label == targetLabel) {
-            if (mainIndices.size() < totalMain)
-                mainIndices.push_back(index);
-        }
-        else {
-            if (anomalousIndices.size() < totalAnomalous)
-                anomalousIndices.push_back(index);
+            return 1;
         }
 
-        index++;
+        h->load(*res->getComputeSystem(), options._loadFileName);
     }
 
-    // Sampling distributions
-    std::uniform_int_distribution<int> mainDist(0, mainIndices.size() - 1);
-    std::uniform_int_distribution<int> anomolousDist(0, anomalousIndices.size() - 1);
-
-    // Load first digits
-    std::vector<sf::Texture> imgPool(imgPoolSize);
-    std::vector<float> imgSpins(imgPoolSize, 0.0f);
-    std::vector<bool> imgAnomolous(imgPoolSize, false);
-    std::vector<int> imgLabels(imgPoolSize, 0);
-
-    for (int i = 0; i < imgPool.size(); i++) {
-        Image img;
-        int index = mainDist(generator);
+    // Persistent input field, predictions are read in place from the hierarchy
+    util::InputStaging staging;
+    staging.create(h, { ogmaneo::Vec2i(bottomWidth, bottomHeight) });
 
-        loadMNISTimage(fromImageFile, mainIndices[index], img);
-        int label = loadMNISTlabel(fromLabelFile, mainIndices[index]);
+    ogmaneo::ValueField2D &inputField = staging.getInput(0);
 
-        // Convert to SFML image
-        sf::Image digit;
-        digit.create(28, 28);
+    // Digits on screen, newest first, with slots recycled as digits scroll off
+    mnist::DigitStream digitStream;
 
-        for (int x = 0; x < digit.getSize().x; x++)
-            for (int y = 0; y < digit.getSize().y; y++) {
-                int index = x + y * digit.getSize().x;
-
-                sf::Color c = sf::Color::White;
+    if (!digitStream.create(mnistData, classIndex, streamParams, seed))
+        return 1;
 
-                c.a = img._intensities[index];
+    mnist::AnomalyTraceWriter trace;
 
-                digit.setPixel(x, y, c);
-            }
+    if (!options._traceFileName.empty() && !trace.create(options._traceFileName, detector)) {
+        std::cerr << "Could not write " << options._traceFileName << std::endl;
 
-        imgPool[i].loadFromImage(digit);
-        imgLabels[i] = label;
+        return 1;
     }
 
-    // Total width of image pool in pixels
-    float imgsSize = spacing * imgPool.size();
+    // Move the digits, score the prediction of the composited input, then step the hierarchy
+    auto simulate = [&](bool trainMode) {
+        StepResult result;
 
-    // Current position
-    float position = 0.0f;
+        // Anomalous digits only appear while detecting
+        result._newDigit = digitStream.advance(!trainMode);
 
-    // Average anomaly score
-    float averageScore = 1.0f;
+        // Composite the digits into the input field
+        digitStream.composite(compositor, inputField.getData().data(), bottomHeight);
 
-    // Number of anomalously flagged successors
-    int successorCount = 0;
+        // ------------------------------------- Anomaly detection -------------------------------------
 
-    // Whether the previous digit was flagged as anomalous
-    float prevAnomalous = 0.0f;
+        // Compare input and pred fields (distance)
+        result._score = mnist::computeAnomalyScore(inputField.getData().data(), staging.getPrediction(0).getData().data(),
+            static_cast<int>(inputField.getData().size()));
 
-    // Statistical counters
-    int numTruePositives = 0;
-    int numFalsePositives = 0;
-    int totalSamples = 0;
+        // Detection, adjusting the average score if in training mode
+        detector.update(result._score, trainMode);
 
-    // Modes
-    bool quit = false;
+        // Hierarchy simulation step
+        staging.activate();
 
-    bool trainMode = true;
+        if (trainMode)
+            staging.learn();
 
-    // Simulaiton loop
-    while (!quit) {
-        // Poll events
-        sf::Event event;
+        // See if an anomaly is in range
+        result._anomalyInRange = digitStream.isAnomalyInRange();
 
-        while (window.pollEvent(event)) {
-            switch (event.type) {
-            case sf::Event::Closed:
-                quit = true;
-                break;
-            default:
-                break;
-            }
-        }
+        if (trace.isOpen())
+            trace.record(result._score, trainMode, result._anomalyInRange, result._newDigit);
 
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape))
-            quit = true;
+        return result;
+    };
 
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::R))
-            trainMode = false;
+    // --------------------------- Headless evaluation ---------------------------
 
-        window.clear();
+    if (options._headless) {
+        if (options._trainSteps > 0) {
+            std::cout << "Training for " << options._trainSteps << " steps" << std::endl;
 
-        // Move digits
-        position += moveSpeed;
+            std::chrono::high_resolution_clock::time_point trainStart = std::chrono::high_resolution_clock::now();
 
-        // If new digit needs to be loaded
-        if (position > spacing) {
-            // Load new digit
-            sf::Texture newImg;
+            for (int s = 0; s < options._trainSteps; s++)
+                simulate(true);
 
-            Image img;
+            std::chrono::duration<float> trainSeconds = std::chrono::high_resolution_clock::now() - trainStart;
 
-            // Load digit, get anomalous status and label
-            bool anomolous = false;
+            std::cout << "Trained in " << trainSeconds.count() << " s (" << options._trainSteps / std::max(0.001f, trainSeconds.count()) << " steps/s)" << std::endl;
+        }
 
-            int label;
+        if (!options._saveFileName.empty()) {
+            h->save(*res->getComputeSystem(), options._saveFileName);
 
-            if (trainMode) {
-                int index = mainDist(generator);
+            if (!detector.save(mnist::AnomalyDetector::getDetectorFileName(options._saveFileName))) {
+                std::cerr << "Could not write " << mnist::AnomalyDetector::getDetectorFileName(options._saveFileName) << std::endl;
 
-                loadMNISTimage(fromImageFile, mainIndices[index], img);
-                label = loadMNISTlabel(fromLabelFile, mainIndices[index]);
+                return 1;
             }
-            else {
-                if (dist01(generator) < anomalyRate) {
-                    int index = anomolousDist(generator);
-
-                    loadMNISTimage(fromImageFile, anomalousIndices[index], img);
-                    label = loadMNISTlabel(fromLabelFile, anomalousIndices[index]);
+        }
 
-                    anomolous = true;
-                }
-                else {
-                    int index = mainDist(generator);
+        // The evaluation stream depends only on the seed, not on how long training ran
+        digitStream.seed(seed + 1);
 
-                    loadMNISTimage(fromImageFile, mainIndices[index], img);
-                    label = loadMNISTlabel(fromLabelFile, mainIndices[index]);
-                }
-            }
+        mnist::AnomalyEvaluator evaluator;
 
-            // Convert to SFML image
-            sf::Image digit;
-            digit.create(28, 28);
+        std::chrono::high_resolution_clock::time_point evalStart = std::chrono::high_resolution_clock::now();
 
-            for (int x = 0; x < digit.getSize().x; x++)
-                for (int y = 0; y < digit.getSize().y; y++) {
-                    int index = x + y * digit.getSize().x;
+        while (evaluator.getNumDigits() < options._evalDigits) {
+            StepResult result = simulate(false);
 
-                    sf::Color c = sf::Color::White;
+            if (result._newDigit)
+                evaluator.addDigit();
 
-                    c.a = img._intensities[index];
+            evaluator.record(result._score, detector.getAverageScore(), result._anomalyInRange, detector.isFirstDetection());
+        }
 
-                    digit.setPixel(x, y, c);
-                }
+        evaluator.finish();
 
-            newImg.loadFromImage(digit);
+        std::chrono::duration<float> evalSeconds = std::chrono::high_resolution_clock::now() - evalStart;
 
-            // Update pool information
-            imgPool.insert(imgPool.begin(), newImg);
-            imgPool.pop_back();
+        std::cout << "Evaluated in " << evalSeconds.count() << " s (" << evaluator.getNumSteps() / std::max(0.001f, evalSeconds.count()) << " steps/s)" << std::endl;
 
-            imgSpins.insert(imgSpins.begin(), 0.0f);
-            imgSpins.pop_back();
+        return report(evaluator) ? 0 : 1;
+    }
 
-            imgAnomolous.insert(imgAnomolous.begin(), anomolous);
-            imgAnomolous.pop_back();
+    // --------------------------- Create the Windows ---------------------------
 
-            imgLabels.insert(imgLabels.begin(), label);
-            imgLabels.pop_back();
+    sf::RenderWindow window;
 
-            totalSamples++;
+    window.create(sf::VideoMode(1024, 512), "MNIST Anomaly Detection");
 
-            // Reset position
-            position = 0.0f;
-        }
+    // --------------------------- Plot ---------------------------
 
-        // Render to render target
-        rt.clear();
+    vis::Plot plot;
+    plot._curves.resize(1);
+    plot._curves[0]._shadow = 0.1f;	
 
-        float offset = -imgsSize * 0.5f;
+    plot._curves[0]._name = "Prediction Error";
 
-        for (int i = 0; i < imgPool.size(); i++) {
-            // Add spinning motion
-            imgSpins[i] += spinRate;
+    const int overSizeMult = 6; // How many times the graph should extent past what is visible on-screen in terms of anomaly times
 
-            sf::Sprite s;
+    plot._curves[0]._points.resize(bottomWidth * overSizeMult);
 
-            s.setTexture(imgPool[i]);
-            s.setPosition(offset + position + i * spacing + imgPool[i].getSize().x * 0.5f, rt.getSize().y * 0.5f - 14.0f + imgPool[i].getSize().y * 0.5f);
-            s.setOrigin(imgPool[i].getSize().x * 0.5f, imgPool[i].getSize().y * 0.5f);
-            s.setRotation(imgSpins[i]);
+    // Initialize
+    for (int i = 0; i < plot._curves[0]._points.size(); i++) {
+        plot._curves[0]._points[i]._position = sf::Vector2f(i, 0.0f);
+        plot._curves[0]._points[i]._color = sf::Color::Red;
+    }
 
-            rt.draw(s);
-        }
+    // Render target for the plot
+    sf::RenderTexture plotRT;
+    plotRT.create(window.getSize().y, window.getSize().y, false);
 
-        rt.display();
+    // Resources for the plot
+    sf::Texture lineGradient;
+    lineGradient.loadFromFile("resources/lineGradient.png");
 
-        // Get image from render target
-        sf::Image rtImg = rt.getTexture().copyToImage();
+    sf::Font tickFont;
+    
+#ifdef _WINDOWS
+    tickFont.loadFromFile("C:/Windows/Fonts/Arial.ttf");
+#else
+#ifdef __APPLE__
+    tickFont.loadFromFile("/Library/Fonts/Courier New.ttf");
+#else
+    tickFont.loadFromFile("/usr/share/fonts/truetype/freefont/FreeMono.ttf");
+#endif
+#endif
 
-        // ------------------------------------- Anomaly detection -------------------------------------
+    // The composited input, uploaded for display only
+    sf::Texture inputTexture;
+    inputTexture.create(bottomWidth, bottomHeight);
 
-        // Retrieve prediction
-        predField = h->getPredictions().front();
+    std::vector<sf::Uint8> inputPixels(bottomWidth * bottomHeight * 4, 255);
 
-        // Copy image data
-        std::vector<float> rtData(rtImg.getSize().x * rtImg.getSize().y);
+    // Statistical counters
+    int numTruePositives = 0;
+    int numFalsePositives = 0;
+    int totalSamples = 0;
 
-        for (int x = 0; x < rtImg.getSize().x; x++)
-            for (int y = 0; y < rtImg.getSize().y; y++) {
-                sf::Color c = rtImg.getPixel(x, y);
+    // Modes
+    bool quit = false;
 
-                inputField.setValue(ogmaneo::Vec2i(x, y), 0.333f * (c.r / 255.0f + c.b / 255.0f + c.g / 255.0f));
-            }
+    bool trainMode = true;
 
-        // Compare input and pred fields (distance)
-        float anomalyScore = 0.0f;
+    int trainSteps = 0;
 
-        for (int i = 0; i < inputField.getData().size(); i++) {
-            float delta = inputField.getData()[i] - predField.getData()[i];
+    // Simulaiton loop
+    while (!quit) {
+        // Poll events
+        sf::Event event;
 
-            anomalyScore += -delta * delta;
+        while (window.pollEvent(event)) {
+            switch (event.type) {
+            case sf::Event::Closed:
+                quit = true;
+                break;
+            default:
+                break;
+            }
         }
 
-        anomalyScore /= inputField.getData().size();
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape))
+            quit = true;
 
-        // Detection
-        float anomaly = anomalyScore < averageScore * sensitivity ? 1.0f : 0.0f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::R) || (options._trainSteps > 0 && trainSteps >= options._trainSteps))
+            trainMode = false;
 
-        // Successor counting
-        if (anomaly > 0.0f)
-            successorCount++;
-        else
-            successorCount = 0;
+        window.clear();
 
-        // If enough successors, there is a sustained anomaly that needs to be flagged
-        float sustainedAnomaly = successorCount >= numSuccessorsRequired ? 1.0f : 0.0f;
+        StepResult result = simulate(trainMode);
 
-        // Adjust average score if in training mode
         if (trainMode)
-            averageScore = averageDecay * averageScore + (1.0f - averageDecay) * anomalyScore;
-
-        // Hierarchy simulation step
-        std::vector<ogmaneo::ValueField2D> inputVector = { inputField };
+            trainSteps++;
 
-        h->activate(inputVector);
+        if (result._newDigit)
+            totalSamples++;
 
-        if (trainMode)
-            h->learn(inputVector);
+        float sustainedAnomaly = detector.isSustainedAnomaly() ? 1.0f : 0.0f;
 
         // Shift plot y values
         for (int i = plot._curves[0]._points.size() - 1; i >= 1; i--)
@@ -440,34 +460,26 @@ int main() {
         // Add anomaly to plot
         plot._curves[0]._points.front()._position.y = sustainedAnomaly;
 
-        // See if an anomaly is in range
-        int center = imgPoolSize / 2;
-
         // Gather statistics
-        bool anomalyInRange = false;
-
-        for (int dx = -okRange; dx <= okRange; dx++)
-            if (imgAnomolous[center + dx]) {
-                anomalyInRange = true;
-                break;
-            }
-
-        // First detection
-        bool firstDetection = prevAnomalous == 0.0f && sustainedAnomaly == 1.0f;
+        bool firstDetection = detector.isFirstDetection();
 
         if (!trainMode && firstDetection) {
-            if (anomalyInRange)
+            if (result._anomalyInRange)
                 numTruePositives++;
             else
                 numFalsePositives++;
         }
 
-        prevAnomalous = sustainedAnomaly;
-
         // Rendering
         sf::Sprite s;
 
-        s.setTexture(rt.getTexture());
+        for (int i = 0; i < bottomWidth * bottomHeight; i++)
+            inputPixels[i * 4 + 0] = inputPixels[i * 4 + 1] = inputPixels[i * 4 + 2] =
+                static_cast<sf::Uint8>(255.0f * std::min(1.0f, inputField.getData()[i]));
+
+        inputTexture.update(inputPixels.data());
+
+        s.setTexture(inputTexture);
 
         float scale = window.getSize().y / static_cast<float>(bottomHeight);
 
@@ -478,14 +490,14 @@ int main() {
         // Show pool chain
         const float miniChainSpacing = 24.0f;
 
-        for (int i = 0; i < imgPool.size(); i++) {
+        for (int i = 0; i < digitStream.getPool().size(); i++) {
             sf::RectangleShape rs;
             rs.setPosition(i * miniChainSpacing + 4.0f, 4.0f);
 
             sf::Text text;
             text.setFont(tickFont);
             text.setCharacterSize(24);
-            text.setString(std::to_string(imgLabels[i]));
+            text.setString(std::to_string(digitStream.getPool().getLabel(i)));
 
             text.setPosition(rs.getPosition() + sf::Vector2f(2.0f, -2.0f));
 
@@ -0,0 +1,362 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include <SFML/Graphics.hpp>
+
+#include <mnist/MnistDataset.h>
+#include <mnist/DigitPool.h>
+#include <mnist/DigitCompositor.h>
+
+#include <stats/Distance.h>
+#include <stats/RunningStats.h>
+#include <stats/QuantileSketch.h>
+
+#include <util/Simd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+// Time a callable over a number of repetitions, returns seconds per repetition
+template<class T>
+double timeRepeated(int repetitions, T &&function) {
+    // Warm up caches
+    function();
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    for (int r = 0; r < repetitions; r++)
+        function();
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    return elapsed.count() / repetitions;
+}
+
+// One MNIST_Anomaly_Detection input frame (a full digit pool scrolling through a 28x28 field)
+// composited with sprites in a render texture read back to the CPU, against the CPU compositor
+int benchmarkComposite(int repetitions) {
+    const int fieldSize = 28;
+    const int poolSize = 20;
+    const float spacing = 28.0f;
+    const float spinRate = 5.0f;
+
+    mnist::DigitPool digitPool;
+    digitPool.create(poolSize, 28, 28);
+
+    mnist::MnistDataset mnistData;
+
+    if (mnistData.open("resources")) {
+        for (int i = 0; i < poolSize; i++)
+            digitPool.push(mnistData.getImage(i), mnistData.getLabel(i), false);
+    }
+    else {
+        std::cout << "MNIST not found, using random digits" << std::endl;
+
+        std::mt19937 generator(1234);
+        std::uniform_int_distribution<int> byteDist(0, 255);
+
+        std::vector<unsigned char> intensities(28 * 28);
+
+        for (int i = 0; i < poolSize; i++) {
+            for (unsigned char &intensity : intensities)
+                intensity = static_cast<unsigned char>(byteDist(generator));
+
+            digitPool.push(intensities.data(), 0, false);
+        }
+    }
+
+    std::vector<float> field(fieldSize * fieldSize);
+
+    float offset = -spacing * poolSize * 0.5f;
+    float position = 0.0f;
+
+    float checksum = 0.0f;
+
+    std::cout << "Digit compositing, " << poolSize << " digits into " << fieldSize << "x" << fieldSize << std::endl;
+
+    // Previous path: sprites drawn into a render texture, read back and converted per pixel
+    sf::RenderTexture rt;
+
+    double spriteSeconds = 0.0;
+
+    if (rt.create(fieldSize, fieldSize)) {
+        std::vector<sf::Texture> textures(poolSize);
+
+        for (int i = 0; i < poolSize; i++) {
+            sf::Image digit;
+            digit.create(28, 28);
+
+            for (int x = 0; x < 28; x++)
+                for (int y = 0; y < 28; y++) {
+                    sf::Color c = sf::Color::White;
+
+                    c.a = digitPool.getIntensities(i)[x + y * 28];
+
+                    digit.setPixel(x, y, c);
+                }
+
+            textures[i].loadFromImage(digit);
+        }
+
+        spriteSeconds = timeRepeated(repetitions, [&]() {
+            rt.clear();
+
+            digitPool.spin(spinRate);
+            position = std::fmod(position + 1.0f, spacing);
+
+            for (int i = 0; i < poolSize; i++) {
+                sf::Sprite s;
+
+                s.setTexture(textures[i]);
+                s.setPosition(offset + position + i * spacing + 14.0f, fieldSize * 0.5f);
+                s.setOrigin(14.0f, 14.0f);
+                s.setRotation(digitPool.getSpin(i));
+
+                rt.draw(s);
+            }
+
+            rt.display();
+
+            sf::Image rtImg = rt.getTexture().copyToImage();
+
+            for (int x = 0; x < fieldSize; x++)
+                for (int y = 0; y < fieldSize; y++) {
+                    sf::Color c = rtImg.getPixel(x, y);
+
+                    field[x + y * fieldSize] = 0.333f * (c.r / 255.0f + c.b / 255.0f + c.g / 255.0f);
+                }
+
+            checksum += field[fieldSize * fieldSize / 2];
+        });
+
+        std::cout << std::left << std::setw(28) << "RenderTexture readback" << std::right
+            << std::setw(12) << std::fixed << std::setprecision(0) << 1.0 / spriteSeconds << " composites/s" << std::endl;
+    }
+    else
+        std::cout << "No render texture support, skipping the sprite path" << std::endl;
+
+    mnist::DigitCompositor compositor;
+    compositor.create(fieldSize, fieldSize);
+
+    double compositorSeconds = timeRepeated(repetitions, [&]() {
+        compositor.clear(field.data());
+
+        digitPool.spin(spinRate);
+        position = std::fmod(position + 1.0f, spacing);
+
+        for (int i = 0; i < poolSize; i++)
+            compositor.draw(field.data(), digitPool.getIntensities(i), 28, 28,
+                offset + position + i * spacing + 14.0f, fieldSize * 0.5f, digitPool.getSpin(i));
+
+        checksum += field[fieldSize * fieldSize / 2];
+    });
+
+    std::cout << std::left << std::setw(28) << "DigitCompositor" << std::right
+        << std::setw(12) << std::fixed << std::setprecision(0) << 1.0 / compositorSeconds << " composites/s";
+
+    if (spriteSeconds > 0.0)
+        std::cout << std::setw(10) << std::setprecision(2) << spriteSeconds / compositorSeconds << "x";
+
+    std::cout << std::endl;
+
+    // Keep the results observable so the loops are not optimized away
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
+
+void printRate(const std::string &name, double seconds, const std::string &unit) {
+    std::cout << std::left << std::setw(28) << name << std::right
+        << std::setw(12) << std::fixed << std::setprecision(0) << 1.0 / seconds << " " << unit << std::endl;
+}
+
+// Per step anomaly score of a 28x28 prediction (the previous scalar loop against the vectorized
+// distances), streaming statistics updates, and the accuracy of the quantile sketches
+int benchmarkStats(int repetitions) {
+    const int size = 28 * 28;
+    const int numValues = 100000;
+
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> unitDist(0.0f, 1.0f);
+
+    std::vector<float> input(size);
+    std::vector<float> prediction(size);
+
+    for (int i = 0; i < size; i++) {
+        input[i] = unitDist(generator);
+        prediction[i] = unitDist(generator);
+    }
+
+    float checksum = 0.0f;
+
+    std::cout << "Prediction distances, " << size << " values (" << util::getSimdName() << ")" << std::endl;
+
+    double scalarSeconds = timeRepeated(repetitions, [&]() {
+        float score = 0.0f;
+
+        for (int i = 0; i < size; i++) {
+            float delta = input[i] - prediction[i];
+
+            score += -delta * delta;
+        }
+
+        checksum += score / size;
+    });
+
+    printRate("Scalar squared error", scalarSeconds, "scores/s");
+
+    double mseSeconds = timeRepeated(repetitions, [&]() {
+        checksum += stats::meanSquaredError(input.data(), prediction.data(), size);
+    });
+
+    std::cout << std::left << std::setw(28) << "meanSquaredError" << std::right
+        << std::setw(12) << std::fixed << std::setprecision(0) << 1.0 / mseSeconds << " scores/s"
+        << std::setw(10) << std::setprecision(2) << scalarSeconds / mseSeconds << "x" << std::endl;
+
+    printRate("meanAbsoluteError", timeRepeated(repetitions, [&]() {
+        checksum += stats::meanAbsoluteError(input.data(), prediction.data(), size);
+    }), "scores/s");
+
+    printRate("cosineDistance", timeRepeated(repetitions, [&]() {
+        checksum += stats::cosineDistance(input.data(), prediction.data(), size);
+    }), "scores/s");
+
+    // Scores shaped like anomaly scores, mostly small errors with a long tail
+    std::exponential_distribution<double> errorDist(20.0);
+
+    std::vector<double> values(numValues);
+
+    for (double &value : values)
+        value = -errorDist(generator);
+
+    std::cout << std::endl << "Streaming statistics, " << numValues << " values" << std::endl;
+
+    stats::Welford welford;
+
+    printRate("Welford", timeRepeated(1, [&]() {
+        welford.reset();
+
+        for (double value : values)
+            welford.add(value);
+    }) / numValues, "updates/s");
+
+    stats::Ewma ewma;
+    ewma.create(0.999);
+
+    printRate("Ewma", timeRepeated(1, [&]() {
+        ewma.reset();
+
+        for (double value : values)
+            ewma.add(value);
+    }) / numValues, "updates/s");
+
+    stats::P2Quantile p2;
+
+    printRate("P2Quantile", timeRepeated(1, [&]() {
+        p2.create(0.01);
+
+        for (double value : values)
+            p2.add(value);
+    }) / numValues, "updates/s");
+
+    stats::TDigest digest;
+
+    printRate("TDigest", timeRepeated(1, [&]() {
+        digest.create(100.0);
+
+        for (double value : values)
+            digest.add(value);
+
+        // Include the final merge
+        digest.getNumCentroids();
+    }) / numValues, "updates/s");
+
+    checksum += static_cast<float>(welford.getMean() + ewma.getMean());
+
+    // Sketch estimates of the low tail, where anomaly thresholds sit
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto exactQuantile = [&sorted](double q) {
+        return sorted[static_cast<size_t>(std::round(q * (sorted.size() - 1)))];
+    };
+
+    std::cout << std::endl << std::setw(10) << "Quantile" << std::setw(14) << "Exact" << std::setw(14) << "P2Quantile" << std::setw(14) << "TDigest" << std::endl;
+
+    const double quantiles[] = { 0.001, 0.01, 0.05, 0.5 };
+
+    for (double q : quantiles) {
+        stats::P2Quantile estimator;
+        estimator.create(q);
+
+        for (double value : values)
+            estimator.add(value);
+
+        std::cout << std::setprecision(3) << std::setw(10) << q << std::setprecision(6) << std::setw(14) << exactQuantile(q)
+            << std::setw(14) << estimator.getQuantile() << std::setw(14) << digest.getQuantile(q) << std::endl;
+    }
+
+    std::cout << "TDigest kept " << digest.getNumCentroids() << " centroids" << std::endl;
+
+    // Keep the results observable so the loops are not optimized away
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+    return 0;
+}
+
+// Optional positional integer argument, fallback when absent. False when it is not a whole positive number
+bool intArgument(int argc, char *argv[], int index, int fallback, int &value) {
+    if (index >= argc) {
+        value = fallback;
+        return true;
+    }
+
+    char* end;
+
+    errno = 0;
+
+    long parsed = std::strtol(argv[index], &end, 10);
+
+    if (end == argv[index] || *end != '\0' || errno == ERANGE || parsed <= 0 || parsed > INT_MAX)
+        return false;
+
+    value = static_cast<int>(parsed);
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "composite";
+
+    if (mode == "composite") {
+        int repetitions;
+
+        if (intArgument(argc, argv, 2, 2000, repetitions))
+            return benchmarkComposite(repetitions);
+    }
+
+    if (mode == "stats") {
+        int repetitions;
+
+        if (intArgument(argc, argv, 2, 1000000, repetitions))
+            return benchmarkStats(repetitions);
+    }
+
+    std::cout << "Usage: " << argv[0] << " composite|stats [repetitions]" << std::endl;
+
+    return 1;
+}
@@ -0,0 +1,49 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include <util/MetricsLog.h>
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// Convert a binary metrics log (Video_Prediction --metrics) to CSV, on stdout or into a file
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " metrics.bin [metrics.csv]" << std::endl;
+        return 1;
+    }
+
+    util::MetricsReader reader;
+
+    if (!reader.open(argv[1])) {
+        std::cerr << "Could not read metrics log: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::FILE* out = argc > 2 ? std::fopen(argv[2], "w") : stdout;
+
+    if (out == nullptr) {
+        std::cerr << "Could not open output: " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::fprintf(out, "step,pass,frame,mse,step_seconds,decode_seconds\n");
+
+    for (size_t i = 0; i < reader.getNumRecords(); i++) {
+        const util::MetricsRecord &record = reader.getRecord(i);
+
+        std::fprintf(out, "%llu,%d,%d,%.9g,%.9g,%.9g\n", static_cast<unsigned long long>(record._step),
+            record._pass, record._frame, record._mse, record._stepSeconds, record._decodeSeconds);
+    }
+
+    if (out != stdout)
+        std::fclose(out);
+
+    return 0;
+}
@@ -0,0 +1,411 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include <SFML/Graphics.hpp>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui.hpp>
+
+#include <neo/Architect.h>
+#include <neo/Hierarchy.h>
+
+#include <util/Simd.h>
+#include <video/PixelKernels.h>
+#include <video/Resampler.h>
+#include <video/FrameIndex.h>
+#include <video/FrameSource.h>
+#include <video/YuvFramePredictor.h>
+#include <util/InputStaging.h>
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ogmaneo;
+
+// Time a callable over a number of repetitions, returns seconds per repetition
+template<class T>
+double timeRepeated(int repetitions, T &&function) {
+    // Warm up caches
+    function();
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    for (int r = 0; r < repetitions; r++)
+        function();
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    return elapsed.count() / repetitions;
+}
+
+void reportRate(const std::string &name, double secondsPerFrame, int pixels, double baseline) {
+    double pixelsPerSecond = pixels / secondsPerFrame;
+
+    std::cout << std::left << std::setw(28) << name << std::right
+        << std::setw(10) << std::fixed << std::setprecision(1) << pixelsPerSecond * 1e-6 << " Mpixels/s"
+        << std::setw(10) << std::setprecision(2) << baseline / secondsPerFrame << "x" << std::endl;
+}
+
+// Per pixel input conversion, error and corruption kernels
+int benchmarkKernels(int netScale) {
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<int> byteDist(0, 255);
+    std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+
+    const int planeSize = netScale * netScale;
+    const float blendPred = 0.1f;
+    const int repetitions = 200;
+
+    // Random frame in each of the layouts
+    sf::Image reImg;
+    reImg.create(netScale, netScale);
+
+    std::vector<unsigned char> planes(planeSize * 3);
+    std::vector<unsigned char> bgr(planeSize * 3);
+
+    for (int x = 0; x < netScale; x++)
+        for (int y = 0; y < netScale; y++) {
+            sf::Color c(byteDist(generator), byteDist(generator), byteDist(generator));
+
+            int index = x + y * netScale;
+
+            reImg.setPixel(x, y, c);
+
+            planes[index] = c.r;
+            planes[index + planeSize] = c.g;
+            planes[index + planeSize * 2] = c.b;
+
+            bgr[index * 3 + 0] = c.b;
+            bgr[index * 3 + 1] = c.g;
+            bgr[index * 3 + 2] = c.r;
+        }
+
+    ValueField2D inputFieldR(Vec2i(netScale, netScale), 0.0f);
+    ValueField2D inputFieldG(Vec2i(netScale, netScale), 0.0f);
+    ValueField2D inputFieldB(Vec2i(netScale, netScale), 0.0f);
+    ValueField2D predFieldR(Vec2i(netScale, netScale), 0.0f);
+    ValueField2D predFieldG(Vec2i(netScale, netScale), 0.0f);
+    ValueField2D predFieldB(Vec2i(netScale, netScale), 0.0f);
+
+    for (int i = 0; i < planeSize; i++) {
+        predFieldR.getData()[i] = dist01(generator);
+        predFieldG.getData()[i] = dist01(generator);
+        predFieldB.getData()[i] = dist01(generator);
+    }
+
+    float errorSink = 0.0f;
+
+    // Previous Video_Prediction input loop
+    double baseline = timeRepeated(repetitions, [&]() {
+        float predError = 0.0;
+
+        for (unsigned int x = 0; x < reImg.getSize().x; x++)
+            for (unsigned int y = 0; y < reImg.getSize().y; y++) {
+                sf::Color c = reImg.getPixel(x, y);
+
+                float errr = c.r / 255.0f - predFieldR.getValue(Vec2i(x, y));
+                float errg = c.g / 255.0f - predFieldG.getValue(Vec2i(x, y));
+                float errb = c.b / 255.0f - predFieldB.getValue(Vec2i(x, y));
+                predError += ((errr * errr) + (errg * errg) + (errb * errb)) / 3.0f;
+
+                inputFieldR.setValue(Vec2i(x, y), c.r / 255.0f * (1.0f - blendPred) + predFieldR.getValue(Vec2i(x, y)) * blendPred);
+                inputFieldG.setValue(Vec2i(x, y), c.g / 255.0f * (1.0f - blendPred) + predFieldG.getValue(Vec2i(x, y)) * blendPred);
+                inputFieldB.setValue(Vec2i(x, y), c.b / 255.0f * (1.0f - blendPred) + predFieldB.getValue(Vec2i(x, y)) * blendPred);
+            }
+
+        errorSink += predError;
+    });
+
+    double planar = timeRepeated(repetitions, [&]() {
+        errorSink += video::encodeFramePlanar(planes.data(), planeSize,
+            predFieldR.getData().data(), predFieldG.getData().data(), predFieldB.getData().data(),
+            inputFieldR.getData().data(), inputFieldG.getData().data(), inputFieldB.getData().data(), blendPred);
+    });
+
+    double interleaved = timeRepeated(repetitions, [&]() {
+        errorSink += video::encodeFrameBGR(bgr.data(), planeSize,
+            predFieldR.getData().data(), predFieldG.getData().data(), predFieldB.getData().data(),
+            inputFieldR.getData().data(), inputFieldG.getData().data(), inputFieldB.getData().data(), blendPred);
+    });
+
+    std::cout << "Input kernels, " << netScale << "x" << netScale << " RGB, " << util::getSimdName() << " build" << std::endl;
+
+    reportRate("getPixel/setValue loop", baseline, planeSize, baseline);
+    reportRate("encodeFramePlanar", planar, planeSize, baseline);
+    reportRate("encodeFrameBGR", interleaved, planeSize, baseline);
+
+    // Keep the results observable so the loops are not optimized away
+    std::cout << "(checksum " << errorSink << ")" << std::endl;
+
+    return 0;
+}
+
+// Time per training pass (decode, resample and input encoding of every fed frame) at several frame skips,
+// previous full decode of every frame against grab-only skipping
+int benchmarkSkip(const std::string &fileName, int netScale) {
+    cv::VideoCapture capture(fileName);
+
+    if (!capture.isOpened()) {
+        std::cerr << "Could not open capture: " << fileName << std::endl;
+        return 1;
+    }
+
+    video::FrameIndex frameIndex;
+
+    if (!frameIndex.loadOrBuild(fileName, capture)) {
+        std::cerr << "Could not index capture: " << fileName << std::endl;
+        return 1;
+    }
+
+    video::Resampler resampler;
+    resampler.create(static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)), netScale, netScale);
+
+    const int planeSize = netScale * netScale;
+    const float blendPred = 0.1f;
+
+    std::vector<unsigned char> planes(planeSize * 3);
+    std::vector<float> inputs(planeSize * 3, 0.0f);
+    std::vector<float> preds(planeSize * 3, 0.5f);
+
+    float errorSink = 0.0f;
+
+    auto encode = [&]() {
+        errorSink += video::encodeFramePlanar(planes.data(), planeSize,
+            preds.data(), preds.data() + planeSize, preds.data() + planeSize * 2,
+            inputs.data(), inputs.data() + planeSize, inputs.data() + planeSize * 2, blendPred);
+    };
+
+    std::cout << "Training pass input, " << fileName << " (" << frameIndex.getNumFrames() << " frames) at " << netScale << "x" << netScale << std::endl;
+
+    const int frameSkips[] = { 1, 4, 16 };
+
+    for (int frameSkip : frameSkips) {
+        cv::Mat frame;
+
+        // Previous Video_Prediction loop, every frame decoded and converted
+        capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+
+        int baselineFrames = 0;
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+        for (;;) {
+            for (int i = 0; i < frameSkip; i++)
+                capture >> frame;
+
+            if (frame.empty())
+                break;
+
+            resampler.resample(frame.data, frame.step, planes.data());
+
+            encode();
+
+            baselineFrames++;
+        }
+
+        std::chrono::duration<double> baseline = std::chrono::high_resolution_clock::now() - start;
+
+        video::CaptureFrameSource source(capture, resampler, frameSkip);
+        source.setNumFrames(frameIndex.getNumFrames());
+        source.rewind();
+
+        int fedFrames = 0;
+        int sourceFrame;
+
+        start = std::chrono::high_resolution_clock::now();
+
+        while (source.read(planes.data(), sourceFrame)) {
+            encode();
+
+            fedFrames++;
+        }
+
+        std::chrono::duration<double> skipping = std::chrono::high_resolution_clock::now() - start;
+
+        std::cout << "frameSkip " << std::setw(2) << frameSkip << ": "
+            << std::fixed << std::setprecision(3) << baseline.count() << " s/pass decode all (" << baselineFrames << " fed), "
+            << skipping.count() << " s/pass grab-only (" << fedFrames << " fed, " << source.getNumGrabs() << " grabs), "
+            << std::setprecision(2) << baseline.count() / skipping.count() << "x" << std::endl;
+    }
+
+    std::cout << "(checksum " << errorSink << ")" << std::endl;
+
+    return 0;
+}
+
+// Training throughput and prediction error of RGB input layers against Y and subsampled U, V layers.
+// Both hierarchies use the Video_Prediction layer configuration and train on the same decoded frames
+int benchmarkColorModes(const std::string &fileName, int netScale, int maxFrames, int numPasses) {
+    cv::VideoCapture capture(fileName);
+
+    if (!capture.isOpened()) {
+        std::cerr << "Could not open capture: " << fileName << std::endl;
+        return 1;
+    }
+
+    video::Resampler resampler;
+    resampler.create(static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH)), static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT)), netScale, netScale);
+
+    const int frameSkip = 4;
+    const int planeSize = netScale * netScale;
+
+    // Decode up front so only the hierarchy and its input conversion are timed
+    std::vector<std::vector<unsigned char>> frames;
+
+    video::CaptureFrameSource source(capture, resampler, frameSkip);
+
+    std::vector<unsigned char> planes(planeSize * 3);
+    int sourceFrame;
+
+    while (static_cast<int>(frames.size()) < maxFrames && source.read(planes.data(), sourceFrame))
+        frames.push_back(planes);
+
+    if (frames.empty()) {
+        std::cerr << "No frames in capture: " << fileName << std::endl;
+        return 1;
+    }
+
+    std::vector<int> layerSizes;
+
+    if (netScale > 128) {
+        layerSizes.push_back(96);
+        layerSizes.push_back(96);
+        layerSizes.push_back(96);
+        layerSizes.push_back(60);
+        layerSizes.push_back(60);
+        layerSizes.push_back(60);
+    }
+    else {
+        layerSizes.push_back(96);
+        layerSizes.push_back(96);
+        layerSizes.push_back(60);
+        layerSizes.push_back(60);
+    }
+
+    std::cout << "Color modes, " << fileName << " (" << frames.size() << " frames, skip " << frameSkip << ") at " << netScale << "x" << netScale <<
+        ", " << layerSizes.size() << " layers, " << numPasses << " passes" << std::endl;
+
+    for (int yuv = 0; yuv < 2; yuv++) {
+        int chromaSize = yuv ? video::YuvFramePredictor::getChromaSize(netScale) : netScale;
+
+        std::shared_ptr<Resources> res = std::make_shared<Resources>();
+        res->create(ComputeSystem::_gpu);
+
+        Architect arch;
+        arch.initialize(1234, res);
+
+        arch.addInputLayer(Vec2i(netScale, netScale));
+        arch.addInputLayer(Vec2i(chromaSize, chromaSize));
+        arch.addInputLayer(Vec2i(chromaSize, chromaSize));
+
+        for (int l = 0; l < static_cast<int>(layerSizes.size()); l++)
+            arch.addHigherLayer(Vec2i(layerSizes[l], layerSizes[l]), l == 0 ? _distance : _chunk);
+
+        std::shared_ptr<Hierarchy> h = arch.generateHierarchy();
+
+        util::InputStaging staging;
+        staging.create(h, { Vec2i(netScale, netScale), Vec2i(chromaSize, chromaSize), Vec2i(chromaSize, chromaSize) });
+
+        video::HierarchyFramePredictor rgbPredictor(staging);
+        video::YuvFramePredictor yuvPredictor;
+
+        if (yuv)
+            yuvPredictor.create(staging, netScale, netScale);
+
+        video::FramePredictor &predictor = yuv ? static_cast<video::FramePredictor&>(yuvPredictor) : rgbPredictor;
+
+        double seconds = 0.0;
+        double lastPassError = 0.0;
+
+        for (int pass = 0; pass < numPasses; pass++) {
+            lastPassError = 0.0;
+
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+            for (const std::vector<unsigned char> &frame : frames) {
+                // Error of the prediction of this frame, always measured in RGB
+                lastPassError += video::encodeFramePlanar(frame.data(), planeSize,
+                    predictor.getPredictionData(0), predictor.getPredictionData(1), predictor.getPredictionData(2),
+                    predictor.getInputData(0), predictor.getInputData(1), predictor.getInputData(2), 0.0f) / planeSize;
+
+                predictor.activate();
+                predictor.learn();
+            }
+
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+            seconds += elapsed.count();
+        }
+
+        std::cout << std::left << std::setw(6) << (yuv ? "YUV" : "RGB") << std::right
+            << std::setw(10) << (planeSize + chromaSize * chromaSize * 2) << " inputs/frame"
+            << std::setw(10) << std::fixed << std::setprecision(1) << (frames.size() * numPasses / seconds) << " frames/s"
+            << "  last pass MSE " << std::setprecision(5) << lastPassError / frames.size() << std::endl;
+    }
+
+    return 0;
+}
+
+// Optional positional integer argument, fallback when absent. False when it is not a whole positive number
+bool intArgument(int argc, char *argv[], int index, int fallback, int &value) {
+    if (index >= argc) {
+        value = fallback;
+        return true;
+    }
+
+    char* end;
+
+    errno = 0;
+
+    long parsed = std::strtol(argv[index], &end, 10);
+
+    if (end == argv[index] || *end != '\0' || errno == ERANGE || parsed <= 0 || parsed > INT_MAX)
+        return false;
+
+    value = static_cast<int>(parsed);
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "kernels";
+
+    if (mode == "kernels") {
+        int netScale;
+
+        if (intArgument(argc, argv, 2, 192, netScale))
+            return benchmarkKernels(netScale);
+    }
+
+    if (mode == "skip" && argc > 2) {
+        int netScale;
+
+        if (intArgument(argc, argv, 3, 192, netScale))
+            return benchmarkSkip(argv[2], netScale);
+    }
+
+    if (mode == "yuv" && argc > 2) {
+        int netScale, maxFrames, numPasses;
+
+        if (intArgument(argc, argv, 3, 128, netScale) && intArgument(argc, argv, 4, 512, maxFrames) && intArgument(argc, argv, 5, 4, numPasses))
+            return benchmarkColorModes(argv[2], netScale, maxFrames, numPasses);
+    }
+
+    std::cout << "Usage: " << argv[0] << " kernels [netScale]" << std::endl;
+    std::cout << "       " << argv[0] << " skip <video> [netScale]" << std::endl;
+    std::cout << "       " << argv[0] << " yuv <video> [netScale] [maxFrames] [passes]" << std::endl;
+
+    return 1;
+}
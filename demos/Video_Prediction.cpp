@@ -13,18 +13,191 @@
 #include <SFML/Graphics.hpp>
 
 #include <time.h>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <random>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
 
 #include <neo/Architect.h>
 #include <neo/Hierarchy.h>
 
 #include <vis/DebugWindow.h>
+#include <vis/ErrorGraph.h>
+#include <util/InputStaging.h>
+#include <util/Checkpointer.h>
+#include <util/MetricsLog.h>
+#include <video/FrameCache.h>
+#include <video/FrameIndex.h>
+#include <video/Resampler.h>
+#include <video/PixelKernels.h>
+#include <video/FramePipeline.h>
+#include <video/ClipDataset.h>
+#include <video/RolloutGenerator.h>
+#include <video/RolloutEvaluator.h>
+#include <video/TiledHierarchy.h>
+#include <video/YuvFramePredictor.h>
+#include <video/ReplayScheduler.h>
 
 using namespace ogmaneo;
 using namespace cv;
 
-int main() {
+// Command line options
+struct Options {
+    // Train without a window, reporting throughput to the terminal
+    bool _headless;
+
+    // Hierarchy file to write after training (empty for none)
+    std::string _saveFileName;
+
+    // Directory or manifest of clips to train on instead of the single movie (empty for none)
+    std::string _datasetPath;
+
+    // Predicted frames to write after training as raw RGBA (0 for none)
+    int _rolloutFrames;
+    std::string _rolloutFileName;
+
+    // Periodic checkpoints during training, written as <prefix>.<frames>.ohr (empty prefix for none)
+    std::string _checkpointPrefix;
+    int _checkpointFrames;
+    float _checkpointMinutes;
+    int _checkpointKeep;
+
+    // Binary per frame metrics log (empty for none), convert with Metrics_To_CSV
+    std::string _metricsFileName;
+
+    // Trained hierarchy to evaluate instead of training (empty for none)
+    std::string _evaluateFileName;
+    int _evalSeedFrames;
+    int _evalHorizon;
+    int _evalStarts;
+
+    // Evaluation table as CSV (empty for none)
+    std::string _evalCsvFileName;
+
+    // Network input size override (0 for the movie's default)
+    int _netScale;
+
+    // Split frames over hierarchies of this tile size (0 for a single hierarchy)
+    int _tileSize;
+    int _tileOverlap;
+
+    // Workers running the tiles, each with its own OpenCL context and queue
+    int _tileWorkers;
+
+    // Feed luma and subsampled chroma instead of RGB
+    bool _yuv;
+
+    // Training passes, 0 for the default
+    int _passes;
+
+    // Replay high error segments after the first pass and stop once the error plateaus
+    bool _replay;
+
+    // Stop once the estimated MSE over the movie reaches this (0 for none)
+    float _targetMSE;
+
+    Options()
+        : _headless(false), _rolloutFrames(0), _checkpointFrames(0), _checkpointMinutes(10.0f), _checkpointKeep(3),
+        _evalSeedFrames(8), _evalHorizon(16), _evalStarts(32), _netScale(0), _tileSize(0), _tileOverlap(16), _tileWorkers(1), _yuv(false),
+        _passes(0), _replay(false), _targetMSE(0.0f)
+    {}
+};
+
+bool parseOptions(int argc, char *argv[], Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg(argv[i]);
+
+        // std::stoi and std::stof throw on values that are not numbers or out of range
+        try {
+            if (arg == "--headless")
+                options._headless = true;
+            else if (arg == "--save" && i + 1 < argc)
+                options._saveFileName = argv[++i];
+            else if (arg == "--dataset" && i + 1 < argc)
+                options._datasetPath = argv[++i];
+            else if (arg == "--metrics" && i + 1 < argc)
+                options._metricsFileName = argv[++i];
+            else if (arg == "--checkpoint" && i + 1 < argc)
+                options._checkpointPrefix = argv[++i];
+            else if (arg == "--checkpoint-frames" && i + 1 < argc)
+                options._checkpointFrames = std::stoi(argv[++i]);
+            else if (arg == "--checkpoint-minutes" && i + 1 < argc)
+                options._checkpointMinutes = std::stof(argv[++i]);
+            else if (arg == "--checkpoint-keep" && i + 1 < argc)
+                options._checkpointKeep = std::stoi(argv[++i]);
+            else if (arg == "--evaluate" && i + 1 < argc)
+                options._evaluateFileName = argv[++i];
+            else if (arg == "--eval-seed" && i + 1 < argc)
+                options._evalSeedFrames = std::stoi(argv[++i]);
+            else if (arg == "--eval-horizon" && i + 1 < argc)
+                options._evalHorizon = std::stoi(argv[++i]);
+            else if (arg == "--eval-starts" && i + 1 < argc)
+                options._evalStarts = std::stoi(argv[++i]);
+            else if (arg == "--eval-csv" && i + 1 < argc)
+                options._evalCsvFileName = argv[++i];
+            else if (arg == "--net-scale" && i + 1 < argc)
+                options._netScale = std::stoi(argv[++i]);
+            else if (arg == "--tiles" && i + 1 < argc)
+                options._tileSize = std::stoi(argv[++i]);
+            else if (arg == "--tile-overlap" && i + 1 < argc)
+                options._tileOverlap = std::stoi(argv[++i]);
+            else if (arg == "--tile-workers" && i + 1 < argc)
+                options._tileWorkers = std::stoi(argv[++i]);
+            else if (arg == "--yuv")
+                options._yuv = true;
+            else if (arg == "--passes" && i + 1 < argc)
+                options._passes = std::stoi(argv[++i]);
+            else if (arg == "--replay")
+                options._replay = true;
+            else if (arg == "--target-mse" && i + 1 < argc)
+                options._targetMSE = std::stof(argv[++i]);
+            else if (arg == "--rollout" && i + 2 < argc) {
+                options._rolloutFrames = std::stoi(argv[++i]);
+                options._rolloutFileName = argv[++i];
+            }
+            else
+                return false;
+        }
+        catch (const std::logic_error &) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+
+    if (!parseOptions(argc, argv, options)) {
+        std::cout << "Usage: " << argv[0] << " [--headless] [--save hierarchy.ohr] [--dataset directory|manifest.txt] [--rollout frames file.rgba]" << std::endl <<
+            "    [--metrics metrics.bin]" << std::endl <<
+            "    [--evaluate hierarchy.ohr] [--eval-seed frames] [--eval-horizon frames] [--eval-starts count] [--eval-csv table.csv]" << std::endl <<
+            "    [--net-scale pixels] [--tiles tileSize] [--tile-overlap pixels] [--tile-workers count] [--yuv]" << std::endl <<
+            "    [--passes count] [--replay] [--target-mse mse]" << std::endl <<
+            "    [--checkpoint prefix] [--checkpoint-frames frames] [--checkpoint-minutes minutes] [--checkpoint-keep count]" << std::endl <<
+            "    (checkpoints are crash safe, not non-blocking: training stalls while each is serialized)" << std::endl;
+        return 1;
+    }
+
+    // Evaluation only reports to the terminal
+    if (!options._evaluateFileName.empty())
+        options._headless = true;
+
+    if (options._tileSize > 0 && !options._checkpointPrefix.empty()) {
+        std::cerr << "Checkpoints are not supported with --tiles" << std::endl;
+        return 1;
+    }
+
+    if (options._tileSize > 0 && options._yuv) {
+        std::cerr << "--yuv is not supported with --tiles" << std::endl;
+        return 1;
+    }
+
     // Initialize a random number generator
     std::mt19937 generator(time(nullptr));
 
@@ -36,12 +209,14 @@ int main() {
 
     sf::RenderWindow window;
 
-    window.create(sf::VideoMode(windowWidth, windowHeight), "Video Test", sf::Style::Default);
+    if (!options._headless) {
+        window.create(sf::VideoMode(windowWidth, windowHeight), "Video Test", sf::Style::Default);
 
-    // Uncap framerate
-    window.setFramerateLimit(0);
+        // Uncap framerate
+        window.setFramerateLimit(0);
+    }
 
-    bool enableDebugWindow = false;
+    bool enableDebugWindow = false && !options._headless;
 
     vis::DebugWindow debugWindow;
 
@@ -56,13 +231,15 @@ int main() {
 
     sf::Font font;
 
+    if (!options._headless) {
 #if defined(_WINDOWS)
-    font.loadFromFile("C:/Windows/Fonts/Arial.ttf");
+        font.loadFromFile("C:/Windows/Fonts/Arial.ttf");
 #elif defined(__APPLE__)
-    font.loadFromFile("/Library/Fonts/Courier New.ttf");
+        font.loadFromFile("/Library/Fonts/Courier New.ttf");
 #else
-    font.loadFromFile("/usr/share/fonts/truetype/freefont/FreeMono.ttf");
+        font.loadFromFile("/usr/share/fonts/truetype/freefont/FreeMono.ttf");
 #endif
+    }
 
     // Parameters
     int netScale;
@@ -93,95 +270,250 @@ int main() {
         layerSizes.push_back(60);
     }
 
-    // Open the video file
-    VideoCapture capture(fileName);
-    Mat frame;
+    if (options._netScale > 0)
+        netScale = options._netScale;
 
-    if (!capture.isOpened()) {
-        std::cerr << "Could not open capture: " << fileName << std::endl;
-        return 1;
-    }
+    const int frameSkip = 4;        // Frames to skip
+    const float videoScale = 1.0f;  // Rescale ratio
+    const float blendPred = 0.0f;   // Ratio of how much prediction to blend in to input (part of input corruption)
 
-    const int movieWidth = static_cast<int>(capture.get(CAP_PROP_FRAME_WIDTH));
-    const int movieHeight = static_cast<int>(capture.get(CAP_PROP_FRAME_HEIGHT));
+    // Stream many clips instead of the single movie
+    bool useDataset = !options._datasetPath.empty();
 
-    if (movieWidth != movieHeight) {
-        std::cerr << "Movie file " << fileName << " has non-square frame" << std::endl;
-        return 1;
+    std::vector<std::string> clips;
+
+    VideoCapture capture;
+
+    // Video rescaling, done on the CPU straight from the decoded frame
+    video::Resampler resampler;
+
+    if (useDataset) {
+        if (!video::listClips(options._datasetPath, clips)) {
+            std::cerr << "No clips found in: " << options._datasetPath << std::endl;
+            return 1;
+        }
     }
+    else {
+        // Open the video file
+        if (!capture.open(fileName)) {
+            std::cerr << "Could not open capture: " << fileName << std::endl;
+            return 1;
+        }
 
-    const int frameSkip = 4;        // Frames to skip
-    const float videoScale = 1.0f;  // Rescale ratio
-    const float blendPred = 0.0f;   // Ratio of how much prediction to blend in to input (part of input corruption)
+        const int movieWidth = static_cast<int>(capture.get(CAP_PROP_FRAME_WIDTH));
+        const int movieHeight = static_cast<int>(capture.get(CAP_PROP_FRAME_HEIGHT));
 
-    // Video rescaling render target
-    sf::RenderTexture rescaleRT;
-    rescaleRT.create(netScale, netScale);
+        if (movieWidth != movieHeight) {
+            std::cerr << "Movie file " << fileName << " has non-square frame" << std::endl;
+            return 1;
+        }
+
+        resampler.create(movieWidth, movieHeight, netScale, netScale, video::Resampler::_area, videoScale);
+    }
 
     // --------------------------- Create the Hierarchy ---------------------------
 
-    std::shared_ptr<ogmaneo::Resources> res = std::make_shared<ogmaneo::Resources>();
+    // Layers of a hierarchy (or of each tile hierarchy) taking inputSize x inputSize frames
+    auto addLayers = [&](ogmaneo::Architect &arch, int inputSize) {
+        int chromaSize = options._yuv ? video::YuvFramePredictor::getChromaSize(inputSize) : inputSize;
 
-    res->create(ogmaneo::ComputeSystem::_gpu);
+        // 3 input layers for RGB, or Y and subsampled U, V
+        arch.addInputLayer(ogmaneo::Vec2i(inputSize, inputSize));
+        arch.addInputLayer(ogmaneo::Vec2i(chromaSize, chromaSize));
+        arch.addInputLayer(ogmaneo::Vec2i(chromaSize, chromaSize));
+
+        for (int l = 0; l < chunkLayers; l++)
+            arch.addHigherLayer(ogmaneo::Vec2i(layerSizes[l], layerSizes[l]), l == 0 ? ogmaneo::_distance : ogmaneo::_chunk);
+    };
+
+    // Split large frames over concurrently running tile hierarchies
+    bool useTiles = options._tileSize > 0;
+
+    std::shared_ptr<ogmaneo::Resources> res = std::make_shared<ogmaneo::Resources>();
 
     ogmaneo::Architect arch;
-    arch.initialize(1234, res);
 
-    // 3 input layers for RGB
-    arch.addInputLayer(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y));
-    arch.addInputLayer(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y));
-    arch.addInputLayer(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y));
+    std::shared_ptr<ogmaneo::Hierarchy> h;
+
+    // Persistent input fields for color components, predictions are read in place from the hierarchy
+    util::InputStaging staging;
+
+    video::TiledHierarchy tiledHierarchy;
+
+    video::YuvFramePredictor yuvPredictor;
 
-    for (int l = 0; l < chunkLayers; l++)
-        arch.addHigherLayer(ogmaneo::Vec2i(layerSizes[l], layerSizes[l]), l == 0 ? ogmaneo::_distance : ogmaneo::_chunk);
+    if (useTiles) {
+        tiledHierarchy.create(netScale, netScale, options._tileSize, options._tileOverlap, addLayers, ogmaneo::ComputeSystem::_gpu, 1234,
+            std::max(1, options._tileWorkers));
+
+        std::cout << "Tiled " << netScale << "x" << netScale << " frames over " << tiledHierarchy.getNumTiles() << " hierarchies on "
+            << tiledHierarchy.getNumWorkers() << " workers" << std::endl;
+    }
+    else {
+        res->create(ogmaneo::ComputeSystem::_gpu);
 
-    // Generate the hierarchy
-    std::shared_ptr<ogmaneo::Hierarchy> h = arch.generateHierarchy();
+        arch.initialize(1234, res);
 
-    if (enableDebugWindow)
-        debugWindow.registerHierarchy(res, h);
+        addLayers(arch, netScale);
+
+        // Generate the hierarchy
+        h = arch.generateHierarchy();
+
+        if (enableDebugWindow)
+            debugWindow.registerHierarchy(res, h);
+
+        if (options._yuv) {
+            int chromaSize = video::YuvFramePredictor::getChromaSize(netScale);
+
+            staging.create(h, { ogmaneo::Vec2i(netScale, netScale), ogmaneo::Vec2i(chromaSize, chromaSize), ogmaneo::Vec2i(chromaSize, chromaSize) });
+
+            yuvPredictor.create(staging, netScale, netScale);
+
+            std::cout << "YUV input: Y " << netScale << "x" << netScale << ", U and V " << chromaSize << "x" << chromaSize << std::endl;
+        }
+        else
+            staging.create(h, { ogmaneo::Vec2i(netScale, netScale), ogmaneo::Vec2i(netScale, netScale), ogmaneo::Vec2i(netScale, netScale) });
+    }
+
+    video::HierarchyFramePredictor hierarchyPredictor(staging);
+
+    video::FramePredictor &predictor = useTiles ? static_cast<video::FramePredictor&>(tiledHierarchy) :
+        options._yuv ? static_cast<video::FramePredictor&>(yuvPredictor) : hierarchyPredictor;
 
     // Whether to save out the Architect and Hierarchy state
-    bool saveArchitectAndHierarchy = false;
+    bool saveArchitectAndHierarchy = !options._saveFileName.empty();
 
     // Whether to reload the hierarchy (ignoring the Architect state, and rely on Architect setup here instead)
     bool reloadHierarchy = false && !saveArchitectAndHierarchy;
 
-    if (saveArchitectAndHierarchy)
+    if (saveArchitectAndHierarchy && !useTiles)
         arch.save("Video_Prediction.oar");
 
-    // Input and prediction fields for color components
-    ValueField2D inputFieldR(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y), 0.0f);
-    ValueField2D inputFieldG(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y), 0.0f);
-    ValueField2D inputFieldB(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y), 0.0f);
-    ValueField2D predFieldR(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y), 0.0f);
-    ValueField2D predFieldG(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y), 0.0f);
-    ValueField2D predFieldB(ogmaneo::Vec2i(rescaleRT.getSize().x, rescaleRT.getSize().y), 0.0f);
+    // Frame count from the index sidecar (or verified container metadata) rather than a full decode
+    video::FrameIndex frameIndex;
+
+    // Frames in the movie, or the clip positions graphed when streaming a dataset
+    int captureLength;
+
+    // Decode and rescale the video once. The first pass decodes on the pipeline thread while
+    // writing the frame cache, later passes (and runs) stream from the cache
+    video::FrameCache frameCache;
+    video::FrameCacheWriter cacheWriter;
+
+    video::CaptureFrameSource captureSource(capture, resampler, frameSkip);
 
-    std::cout << "Running through capture: " << fileName << std::endl;
+    // Clips are opened and fitted to the network size ahead of the decoder
+    const int clipPrefetch = 4;
 
-    int captureLength = static_cast<int>(capture.get(CAP_PROP_FRAME_COUNT));
+    // Clip lengths are only known once streamed, so error is graphed for this many frame positions
+    // within a clip. Later frames are trained on and logged but not graphed
+    const int graphedClipFrames = 512;
 
-    // Calculate actual number of frames
-    int i = 1;
-    for (; i <= captureLength; i++) {
-        capture >> frame;
+    video::ClipDataset clipDataset;
 
-        if (frame.empty())
-            break;
+    if (useDataset) {
+        std::cout << "Streaming " << clips.size() << " clips from: " << options._datasetPath << std::endl;
+
+        clipDataset.create(clips, netScale, netScale, frameSkip, clipPrefetch, generator());
+
+        captureLength = graphedClipFrames;
     }
-	
-    captureLength = i;
+    else {
+        std::cout << "Running through capture: " << fileName << std::endl;
+
+        if (!frameIndex.loadOrBuild(fileName, capture)) {
+            std::cerr << "Could not index capture: " << fileName << std::endl;
+            return 1;
+        }
+
+        captureLength = frameIndex.getNumFrames();
+
+        std::cout << "Capture has " << captureLength << " frames" << (frameIndex.isFromMetadata() ? " (container metadata)" : "") << std::endl;
 
-    std::cout << "Capture has " << captureLength << " frames" << std::endl;
+        captureSource.setNumFrames(captureLength);
 
-    std::vector<float> errors(captureLength, 0.0f);
+        if (!frameCache.open(fileName, netScale, netScale, frameSkip)) {
+            std::cout << "Building frame cache: " << video::FrameCache::getCacheFileName(fileName, netScale, netScale, frameSkip) << std::endl;
+
+            if (cacheWriter.create(fileName, netScale, netScale, frameSkip))
+                captureSource.setCacheWriter(&cacheWriter);
+            else
+                std::cerr << "Could not create frame cache for: " << fileName << std::endl;
+        }
+    }
+
+    video::CacheFrameSource cacheSource(frameCache);
+
+    // Score multi-step rollouts of a trained hierarchy against the real frames
+    if (!options._evaluateFileName.empty()) {
+        if (useDataset) {
+            std::cerr << "Evaluation runs on the single movie, not a --dataset" << std::endl;
+            return 1;
+        }
+
+        std::cout << "Loading hierarchy from " << options._evaluateFileName << std::endl;
+
+        if (useTiles)
+            tiledHierarchy.load(options._evaluateFileName);
+        else
+            h->load(*res->getComputeSystem(), options._evaluateFileName);
+
+        // Rollouts start at arbitrary frames, so they are read from the frame cache
+        if (!frameCache.isOpen()) {
+            std::vector<unsigned char> planes(netScale * netScale * 3);
+            int sourceFrame;
+
+            while (cacheWriter.isOpen() && captureSource.read(planes.data(), sourceFrame)) {}
+
+            captureSource.setCacheWriter(nullptr);
+
+            if (!cacheWriter.isOpen() || !cacheWriter.finish(captureSource.getPosition()) || !frameCache.open(fileName, netScale, netScale, frameSkip)) {
+                std::cerr << "Could not build frame cache for: " << fileName << std::endl;
+                return 1;
+            }
+        }
+
+        video::RolloutEvaluator evaluator;
+        evaluator.create(options._evalSeedFrames, options._evalHorizon, std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+
+        std::chrono::high_resolution_clock::time_point evalStart = std::chrono::high_resolution_clock::now();
+
+        if (!evaluator.evaluate(predictor, frameCache, options._evalStarts)) {
+            std::cerr << "Capture is too short for " << options._evalSeedFrames << " seed and " << options._evalHorizon << " rollout frames" << std::endl;
+            return 1;
+        }
+
+        std::chrono::duration<float> evalSeconds = std::chrono::high_resolution_clock::now() - evalStart;
+
+        std::cout << "Evaluated " << evaluator.getNumStarts() << " rollouts (" << options._evalSeedFrames << " seed frames) in " << evalSeconds.count() << " s" << std::endl;
+
+        evaluator.writeTable(std::cout, false);
+
+        if (!options._evalCsvFileName.empty()) {
+            std::ofstream csv(options._evalCsvFileName);
+
+            evaluator.writeTable(csv, true);
+        }
+
+        return 0;
+    }
+
+    // Decoded frames queued ahead of training
+    const int pipelineCapacity = 8;
+
+    video::FramePipeline pipeline;
+    pipeline.create(netScale, netScale, pipelineCapacity);
+
+    const int planeSize = netScale * netScale;
+
+    // The cache may have been built before the index, so size for whichever saw more frames
+    std::vector<float> errors(std::max(captureLength, frameCache.isOpen() ? frameCache.getSourceFrames() : 0), 0.0f);
 
     // Unit Gaussian noise for input corruption
     std::normal_distribution<float> noiseDist(0.0f, 1.0f);
 
     // Training time
-    const int numIter = 16;
+    const int numIter = options._passes > 0 ? options._passes : 16;
 
     // UI update resolution
     const int progressBarLength = 40;
@@ -202,101 +534,166 @@ int main() {
         graphScaleY = 25.0f;
     }
 
+    // Error graph, leaving room on the right for the average error text
+    vis::ErrorGraph errorGraph;
+    errorGraph.create(static_cast<int>(errors.size()), sf::Vector2f(8.0f, windowHeight - 16.0f), windowWidth - 96.0f,
+        graphScaleX, graphScaleY * 10.0f, 11, graphScaleY);
+
+    // Periodic checkpoints, flushed to disk on a background thread
+    util::Checkpointer checkpointer;
+
+    if (!options._checkpointPrefix.empty())
+        checkpointer.create(options._checkpointPrefix, options._checkpointFrames, options._checkpointMinutes, options._checkpointKeep);
+
+    // Per frame learning curve, written on a background thread
+    util::MetricsLog metricsLog;
+
+    if (!options._metricsFileName.empty() && !metricsLog.create(options._metricsFileName)) {
+        std::cerr << "Could not open metrics log: " << options._metricsFileName << std::endl;
+        return 1;
+    }
+
+    // Frames trained over all passes
+    int64_t framesTrained = 0;
+
+    // Error prioritized replay of the cached frames, planned from the errors measured in earlier passes
+    bool useReplay = options._replay && !useDataset;
+
+    if (options._replay && useDataset)
+        std::cerr << "--replay runs on the single movie, ignored for --dataset" << std::endl;
+
+    video::ReplayScheduler replay;
+
+    video::PlateauDetector plateau;
+    plateau.create();
+
+    // Last measured error of each cached frame
+    std::vector<float> frameErrors;
+
+    // Fill frameErrors from the graphed errors, returns their mean (the whole movie error estimate)
+    auto measureFrameErrors = [&]() {
+        frameErrors.resize(frameCache.getNumFrames());
+
+        float sum = 0.0f;
+
+        for (int f = 0; f < frameCache.getNumFrames(); f++) {
+            frameErrors[f] = errors[std::min((f + 1) * frameCache.getFrameSkip() - 1, static_cast<int>(errors.size()) - 1)];
+
+            sum += frameErrors[f];
+        }
+
+        return sum / std::max(1, frameCache.getNumFrames());
+    };
+
+    std::chrono::high_resolution_clock::time_point trainStart = std::chrono::high_resolution_clock::now();
+
     if (!reloadHierarchy) {
         // Train for a bit
         for (int iter = 0; iter < numIter && !quit; iter++) {
-            std::cout << "Iteration " << (iter + 1) << " of " << numIter << ":" << std::endl;
+            if (!options._headless)
+                std::cout << "Iteration " << (iter + 1) << " of " << numIter << ":" << std::endl;
 
             int currentFrame = 0;
             float movieError = 0.0f;
 
-            capture.set(CAP_PROP_POS_FRAMES,0.0f);
+            video::FrameSource &source = useDataset ? static_cast<video::FrameSource&>(clipDataset) :
+                frameCache.isOpen() ? static_cast<video::FrameSource&>(cacheSource) : captureSource;
 
-            // Run through video
-            do {
-                // Read several discarded frames if frame skip is > 0
-                for (int i = 0; i < frameSkip; i++) {
-                    capture >> frame;
+            // Replay once the cache holds the movie and every frame has been measured
+            bool replayPass = useReplay && iter > 0 && frameCache.isOpen();
 
-                    currentFrame++;
+            if (replayPass) {
+                measureFrameErrors();
 
-                    if (frame.empty())
-                        break;
-                }
+                if (replay.getNumSegments() == 0)
+                    replay.create(frameCache.getNumFrames());
 
-                if (frame.empty())
-                    break;
+                replay.plan(frameErrors, iter);
+            }
+
+            cacheSource.setSchedule(replayPass ? &replay.getSchedule() : nullptr);
+
+            source.rewind();
+
+            // Throughput and error over the pass
+            int passFrames = 0;
+            float passError = 0.0f;
 
-                if (currentFrame > captureLength)
+            std::chrono::high_resolution_clock::time_point passStart = std::chrono::high_resolution_clock::now();
+
+            pipeline.resetStats();
+            pipeline.start(source);
+
+            // Run through video
+            while (!quit) {
+                const video::PipelineFrame* pipelineFrame = pipeline.acquire();
+
+                if (pipelineFrame == nullptr)
                     break;
 
-                // Convert to SFML image
-                sf::Image img;
+                // Index of the fed frame in the source video (or its clip)
+                currentFrame = pipelineFrame->_sourceFrame;
 
-                img.create(frame.cols, frame.rows);
+                // Normalize, corrupt with the previous prediction and measure its error in one pass
+                float predError = video::encodeFramePlanar(pipelineFrame->_planes.data(), planeSize,
+                    predictor.getPredictionData(0), predictor.getPredictionData(1), predictor.getPredictionData(2),
+                    predictor.getInputData(0), predictor.getInputData(1), predictor.getInputData(2), blendPred);
 
-                for (unsigned int x = 0; x < img.getSize().x; x++)
-                    for (unsigned int y = 0; y < img.getSize().y; y++) {
-                        sf::Uint8 r = frame.data[(x + y * img.getSize().x) * 3 + 2];
-                        sf::Uint8 g = frame.data[(x + y * img.getSize().x) * 3 + 1];
-                        sf::Uint8 b = frame.data[(x + y * img.getSize().x) * 3 + 0];
+                float decodeSeconds = pipelineFrame->_decodeSeconds;
 
-                        img.setPixel(x, y, sf::Color(r, g, b));
-                    }
+                pipeline.release();
 
-                // To SFML texture
-                sf::Texture tex;
-                tex.loadFromImage(img);
-                tex.setSmooth(true);
-
-                // Rescale using render target
-                float scale = videoScale * std::min(static_cast<float>(rescaleRT.getSize().x) / img.getSize().x, static_cast<float>(rescaleRT.getSize().y) / img.getSize().y);
-
-                sf::Sprite s;
-                s.setPosition(rescaleRT.getSize().x * 0.5f, rescaleRT.getSize().y * 0.5f);
-                s.setTexture(tex);
-                s.setOrigin(sf::Vector2f(tex.getSize().x * 0.5f, tex.getSize().y * 0.5f));
-                s.setScale(scale, scale);
-
-                rescaleRT.clear();
-                rescaleRT.draw(s);
-                rescaleRT.display();
-
-                // SFML image from rescaled frame
-                sf::Image reImg = rescaleRT.getTexture().copyToImage();
-
-                float predError = 0.0;
-                // Get input buffers
-                for (unsigned int x = 0; x < reImg.getSize().x; x++)
-                    for (unsigned int y = 0; y < reImg.getSize().y; y++) {
-                        sf::Color c = reImg.getPixel(x, y);
-
-                        float errr = c.r / 255.0f - predFieldR.getValue(ogmaneo::Vec2i(x, y));
-                        float errg = c.g / 255.0f - predFieldG.getValue(ogmaneo::Vec2i(x, y));
-                        float errb = c.b / 255.0f - predFieldB.getValue(ogmaneo::Vec2i(x, y));
-                        predError += ((errr * errr) + (errg * errg) + (errb * errb)) / 3.0f;
-
-                        inputFieldR.setValue(ogmaneo::Vec2i(x, y), c.r / 255.0f * (1.0f - blendPred) + predFieldR.getValue(ogmaneo::Vec2i(x, y)) * blendPred);
-                        inputFieldG.setValue(ogmaneo::Vec2i(x, y), c.g / 255.0f * (1.0f - blendPred) + predFieldG.getValue(ogmaneo::Vec2i(x, y)) * blendPred);
-                        inputFieldB.setValue(ogmaneo::Vec2i(x, y), c.b / 255.0f * (1.0f - blendPred) + predFieldB.getValue(ogmaneo::Vec2i(x, y)) * blendPred);
-                    }
+                float frameError = predError / planeSize;
 
-                errors[currentFrame] = predError / (reImg.getSize().x * reImg.getSize().y);
+                passFrames++;
+                passError += frameError;
+
+                // Frames past the graph are not folded into its last bar
+                if (currentFrame < static_cast<int>(errors.size())) {
+                    errors[currentFrame] = frameError;
+
+                    errorGraph.setError(currentFrame, frameError);
+                    errorGraph.setCurrentFrame(currentFrame);
+                }
 
-                std::vector<ogmaneo::ValueField2D> inputVector = { inputFieldR, inputFieldG, inputFieldB };
+                std::chrono::high_resolution_clock::time_point stepStart = std::chrono::high_resolution_clock::now();
 
-                h->activate(inputVector);
-                h->learn(inputVector);
+                predictor.activate();
+                predictor.learn();
 
-                predFieldR = h->getPredictions()[0];
-                predFieldG = h->getPredictions()[1];
-                predFieldB = h->getPredictions()[2];
+                framesTrained++;
 
-                // Show progress bar
-                float ratio = static_cast<float>(currentFrame + 1) / captureLength;
+                if (metricsLog.isOpen()) {
+                    std::chrono::duration<float> stepSeconds = std::chrono::high_resolution_clock::now() - stepStart;
+
+                    util::MetricsRecord record;
+                    record._step = framesTrained;
+                    record._pass = iter;
+                    record._frame = currentFrame;
+                    record._mse = frameError;
+                    record._stepSeconds = stepSeconds.count();
+                    record._decodeSeconds = decodeSeconds;
+                    record._reserved = 0;
+
+                    metricsLog.log(record);
+                }
+
+                if (checkpointer.isDue(framesTrained)) {
+                    float stallSeconds = checkpointer.save(*h, *res->getComputeSystem(), framesTrained);
+
+                    if (!options._headless)
+                        std::cout << std::endl;
+
+                    std::cout << "Checkpoint at " << framesTrained << " frames, training stalled " << (stallSeconds * 1000.0f) << " ms" << std::endl;
+                }
+
+                // Show progress bar, by clips when streaming a dataset
+                float ratio = useDataset ? static_cast<float>(clipDataset.getClipsStarted()) / clipDataset.getNumClips() :
+                    replayPass ? static_cast<float>(passFrames) / replay.getSchedule().size() :
+                    std::min(1.0f, static_cast<float>(currentFrame + 1) / captureLength);
 
                 // Console
-                if (currentFrame % progressUpdateTicks == 0) {
+                if (!options._headless && currentFrame % progressUpdateTicks == 0) {
                     std::cout << "\r";
                     std::cout << "[";
 
@@ -314,7 +711,7 @@ int main() {
                 }
 
                 // UI
-                if (currentFrame % progressUpdateTicks == 0) {
+                if (!options._headless && currentFrame % progressUpdateTicks == 0) {
                     sf::Event windowEvent;
 
                     while (window.pollEvent(windowEvent)) {
@@ -342,40 +739,8 @@ int main() {
 
                     window.draw(rs);
 
-                    float errorTotal = 0.0f;
-
-                    if (graph) {
-                        // Horizontal grid lines
-                        for (int i = 0; i <= 10; i++) {
-                            rs.setPosition(8.0f, windowHeight - 16.0f - graphScaleY * i);
-                            rs.setSize(sf::Vector2f(graphScaleX * captureLength, 1.0f));
-                            rs.setFillColor(sf::Color::White);
-
-                            window.draw(rs);
-                        }
-
-                        // Vertical error bars
-                        for (int i = 0; i < captureLength; i++) {
-                            rs.setPosition(8.0f + graphScaleX * i, windowHeight - 16.0f - graphScaleY * 10.0f * errors[i]);
-                            rs.setSize(sf::Vector2f(graphScaleX, graphScaleY * 10.0f * errors[i]));
-
-                            if (i <= currentFrame)
-                                rs.setFillColor(sf::Color::Red);
-                            else
-                                rs.setFillColor(sf::Color::Green);
-
-                            window.draw(rs);
-
-                            errorTotal += errors[i];
-                        }
-
-                        // Horizontal average error line
-                        rs.setPosition(8.0f, windowHeight - 16.0f - graphScaleY * 10.0f * frameSkip * (errorTotal / captureLength));
-                        rs.setFillColor(sf::Color::Yellow);
-                        rs.setSize(sf::Vector2f(graphScaleX * captureLength, 2.0f));
-
-                        window.draw(rs);
-                    }
+                    if (graph)
+                        errorGraph.draw(window);
 
                     // Progress bar outline
                     rs.setPosition(8.0f, 8.0f);
@@ -389,8 +754,9 @@ int main() {
                     std::string st;
                     st += std::to_string(static_cast<int>(ratio * 100.0f)) +
                         "% (pass " + std::to_string(iter + 1) + " of " + std::to_string(numIter) + ") " +
-                        std::to_string(currentFrame) + "/" + std::to_string(captureLength) + " MSE: " +
-                        std::to_string(predError / (reImg.getSize().x * reImg.getSize().y));
+                        (useDataset ? "clip " + std::to_string(clipDataset.getClipsStarted()) + "/" + std::to_string(clipDataset.getNumClips()) :
+                        std::to_string(currentFrame) + "/" + std::to_string(captureLength)) + " MSE: " +
+                        std::to_string(predError / planeSize);
 
                     sf::Text t;
                     t.setFont(font);
@@ -403,9 +769,9 @@ int main() {
 
                     if (graph) {
                         std::string st2;
-                        st2 += std::to_string(frameSkip * errorTotal / captureLength);
+                        st2 += std::to_string(errorGraph.getAverageError());
                         t.setString(st2);
-                        t.setPosition(16.0f + graphScaleX * captureLength, windowHeight - 16.0f - graphScaleY * 10.0f * frameSkip * (errorTotal / captureLength));
+                        t.setPosition(16.0f + errorGraph.getWidth(), errorGraph.getY(errorGraph.getAverageError()));
 
                         window.draw(t);
                     }
@@ -417,27 +783,98 @@ int main() {
                         debugWindow.display();
                     }
                 }
+            }
+
+            std::chrono::duration<float> passSeconds = std::chrono::high_resolution_clock::now() - passStart;
+
+            if (!options._headless) {
+                // Make sure bar is at 100%
+                std::cout << "\r";
+                std::cout << "[";
+
+                for (int i = 0; i < progressBarLength; i++)
+                    std::cout << "=";
+
+                std::cout << "] 100%";
+
+                std::cout << std::endl;
+            }
+
+            std::cout << "Pass " << (iter + 1) << ": " << passFrames << " frames, " <<
+                (passFrames / std::max(0.001f, passSeconds.count())) << " frames/sec, MSE " <<
+                (passFrames > 0 ? passError / passFrames : 0.0f) << std::endl;
+
+            pipeline.stop();
+
+            video::PipelineStats stats = pipeline.getStats();
+
+            std::cout << "Pipeline: " << stats._framesProduced << " frames, queue occupancy " << stats._averageOccupancy << "/" << stats._capacity <<
+                ", decoder stalls " << stats._producerStalls << ", training stalls " << stats._consumerStalls << std::endl;
+
+            if (useDataset)
+                std::cout << "Dataset: " << clipDataset.getClipsStarted() << " clips, " << clipDataset.getClipsFailed() << " failed, " <<
+                    clipDataset.getPrefetchStalls() << " prefetch stalls" << std::endl;
+
+            // Switch to the cache once the first pass has written it
+            if (cacheWriter.isOpen()) {
+                captureSource.setCacheWriter(nullptr);
 
-            } while (!frame.empty() && !quit);
+                if (quit)
+                    cacheWriter.abort();
+                else if (!cacheWriter.finish(captureSource.getPosition()) || !frameCache.open(fileName, netScale, netScale, frameSkip))
+                    std::cerr << "Could not build frame cache for: " << fileName << std::endl;
+            }
+
+            if (quit)
+                break;
+
+            if (replayPass)
+                std::cout << "Replay: " << replay.getSchedule().size() << " frames, " << replay.getSegmentsSkipped() << " of " << replay.getNumSegments() <<
+                    " segments skipped, " << replay.getSegmentsReplayed() << " replayed" << std::endl;
 
-            // Make sure bar is at 100%
-            std::cout << "\r";
-            std::cout << "[";
+            // Replay passes only measure the frames they feed, so judge progress on the last error of every frame
+            float estimatedMSE = !useDataset && frameCache.isOpen() ? measureFrameErrors() : (passFrames > 0 ? passError / passFrames : 0.0f);
 
-            for (int i = 0; i < progressBarLength; i++)
-                std::cout << "=";
+            if (useReplay || options._targetMSE > 0.0f)
+                std::cout << "Estimated MSE " << estimatedMSE << std::endl;
 
-            std::cout << "] 100%";
+            if (options._targetMSE > 0.0f && estimatedMSE <= options._targetMSE) {
+                std::chrono::duration<float> trainSeconds = std::chrono::high_resolution_clock::now() - trainStart;
 
-            std::cout << std::endl;
+                std::cout << "Reached target MSE " << options._targetMSE << " in " << trainSeconds.count() << " s (" << (iter + 1) << " passes, " <<
+                    framesTrained << " frames)" << std::endl;
+
+                break;
+            }
+
+            if (useReplay && plateau.update(estimatedMSE)) {
+                std::cout << "MSE plateaued, stopping after " << (iter + 1) << " passes" << std::endl;
+
+                break;
+            }
         }
 
+        checkpointer.finish();
+
+        if (metricsLog.isOpen()) {
+            metricsLog.close();
+
+            std::cout << "Metrics: " << metricsLog.getWritten() << " records written, " << metricsLog.getDropped() << " dropped" << std::endl;
+        }
+
+        if (checkpointer.getNumCheckpoints() + checkpointer.getNumFailed() > 0)
+            std::cout << "Checkpoints: " << checkpointer.getNumCheckpoints() << " written, " << checkpointer.getNumFailed() << " failed, stall mean " <<
+                (checkpointer.getMeanStallSeconds() * 1000.0f) << " ms, max " << (checkpointer.getMaxStallSeconds() * 1000.0f) << " ms" << std::endl;
+
         if (saveArchitectAndHierarchy) {
-            std::string fileName = "VideoPrediction.ohr";
+            std::string fileName = options._saveFileName;
 
             std::cout << "Saving hierarchy to " << fileName << std::endl;
 
-            h->save(*res->getComputeSystem(), fileName);
+            if (useTiles)
+                tiledHierarchy.save(fileName);
+            else
+                h->save(*res->getComputeSystem(), fileName);
         }
     }
     else {
@@ -445,18 +882,69 @@ int main() {
 
         std::cout << "Reloading hierarchy from " << fileName << std::endl;
 
-        h->load(*res->getComputeSystem(), fileName);
+        if (useTiles)
+            tiledHierarchy.load(fileName);
+        else
+            h->load(*res->getComputeSystem(), fileName);
+    }
+
+    // Predicted frames are generated on a worker thread, up to this many ahead of the consumer
+    const int rolloutAhead = 16;
+
+    video::RolloutGenerator rollout;
+    rollout.create(predictor, netScale, netScale, rolloutAhead);
+
+    if (options._rolloutFrames > 0) {
+        std::ofstream rolloutFile(options._rolloutFileName, std::ios::binary);
 
-        predFieldR = h->getPredictions()[0];
-        predFieldG = h->getPredictions()[1];
-        predFieldB = h->getPredictions()[2];
+        if (!rolloutFile.is_open()) {
+            std::cerr << "Could not open rollout file: " << options._rolloutFileName << std::endl;
+            return 1;
+        }
+
+        std::cout << "Writing " << options._rolloutFrames << " rollout frames to " << options._rolloutFileName << std::endl;
+
+        std::chrono::high_resolution_clock::time_point rolloutStart = std::chrono::high_resolution_clock::now();
+
+        rollout.start(options._rolloutFrames);
+
+        // File writes overlap with generating the following frames
+        while (const video::RolloutFrame* frame = rollout.acquire(true)) {
+            rolloutFile.write(reinterpret_cast<const char*>(frame->_pixels.data()), frame->_pixels.size());
+
+            rollout.release();
+        }
+
+        rollout.stop();
+
+        std::chrono::duration<float> rolloutSeconds = std::chrono::high_resolution_clock::now() - rolloutStart;
+
+        std::cout << "Rollout: " << rollout.getFramesGenerated() << " frames of " << netScale << "x" << netScale << " RGBA, " <<
+            (rollout.getFramesGenerated() / std::max(0.001f, rolloutSeconds.count())) << " frames/sec" << std::endl;
     }
 
+    if (options._headless)
+        return 0;
+
     // ---------------------------- Presentation Simulation Loop -----------------------------
 
     window.setVerticalSyncEnabled(true);
     quit = false;
 
+    // Persistent texture, updated in place from the rollout frames
+    sf::Texture rolloutTexture;
+    rolloutTexture.create(netScale, netScale);
+
+    float scale = videoScale * std::min(static_cast<float>(window.getSize().x) / netScale, static_cast<float>(window.getSize().y) / netScale);
+
+    sf::Sprite rolloutSprite;
+    rolloutSprite.setPosition(window.getSize().x * 0.5f, window.getSize().y * 0.5f);
+    rolloutSprite.setTexture(rolloutTexture);
+    rolloutSprite.setOrigin(sf::Vector2f(netScale * 0.5f, netScale * 0.5f));
+    rolloutSprite.setScale(sf::Vector2f(scale, scale));
+
+    rollout.start();
+
     do {
         // ----------------------------- Input -----------------------------
 
@@ -477,49 +965,26 @@ int main() {
 
         window.clear();
 
-        std::vector<ogmaneo::ValueField2D> inputVector = { predFieldR, predFieldG, predFieldB };
-        h->activate(inputVector);
-
-        predFieldR = h->getPredictions()[0];
-        predFieldG = h->getPredictions()[1];
-        predFieldB = h->getPredictions()[2];
-
-        sf::Image img;
+        // Show the next finished frame, keeping the last one while the generator catches up
+        const video::RolloutFrame* frame = rollout.acquire(false);
 
-        img.create(rescaleRT.getSize().x, rescaleRT.getSize().y);
+        if (frame != nullptr) {
+            rolloutTexture.update(frame->_pixels.data());
 
-        for (unsigned int x = 0; x < rescaleRT.getSize().x; x++)
-            for (unsigned int y = 0; y < rescaleRT.getSize().y; y++) {
-                sf::Color c;
-
-                c.r = static_cast<sf::Uint8>(255.0f * std::min(1.0f, std::max(0.0f, predFieldR.getValue(ogmaneo::Vec2i(x, y)))));
-                c.g = static_cast<sf::Uint8>(255.0f * std::min(1.0f, std::max(0.0f, predFieldG.getValue(ogmaneo::Vec2i(x, y)))));
-                c.b = static_cast<sf::Uint8>(255.0f * std::min(1.0f, std::max(0.0f, predFieldB.getValue(ogmaneo::Vec2i(x, y)))));
-
-                img.setPixel(x, y, c);
-            }
-
-        sf::Texture tex;
-        tex.loadFromImage(img);
-
-        float scale = videoScale * std::min(static_cast<float>(window.getSize().x) / img.getSize().x, static_cast<float>(window.getSize().y) / img.getSize().y);
-
-        sf::Sprite s;
-        s.setPosition(window.getSize().x * 0.5f, window.getSize().y * 0.5f);
-        s.setTexture(tex);
-        s.setOrigin(sf::Vector2f(tex.getSize().x * 0.5f, tex.getSize().y * 0.5f));
-        s.setScale(sf::Vector2f(scale, scale));
+            rollout.release();
+        }
 
-        window.draw(s);
+        window.draw(rolloutSprite);
 
         window.display();
 
-        if (enableDebugWindow) {
-            debugWindow.update();
+        // The rollout worker owns the hierarchy, so the debug window keeps its last update
+        if (enableDebugWindow)
             debugWindow.display();
-        }
 
     } while (!quit);
 
+    rollout.stop();
+
     return 0;
 }
\ No newline at end of file
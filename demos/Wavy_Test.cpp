@@ -14,6 +14,7 @@
 
 #include <vis/Plot.h>
 #include <vis/DebugWindow.h>
+#include <util/InputStaging.h>
 
 #include <fstream>
 #include <sstream>
@@ -93,8 +94,6 @@ int main() {
     ogmaneo::Architect arch;
     arch.initialize(1234, res);
 
-    ogmaneo::ValueField2D inputField(ogmaneo::Vec2i(1, 1), 0.0f);
-
     arch.addInputLayer(ogmaneo::Vec2i(1, 1));
 
     arch.addHigherLayer(ogmaneo::Vec2i(36, 36), ogmaneo::_distance);
@@ -102,11 +101,15 @@ int main() {
     for (int l = 0; l < 8; l++)
         arch.addHigherLayer(ogmaneo::Vec2i(36, 36), ogmaneo::_chunk);
 
-    ogmaneo::ValueField2D prediction(ogmaneo::Vec2i(1, 1), 0.0f);
-
     // Generate the hierarchy
     std::shared_ptr<ogmaneo::Hierarchy> h = arch.generateHierarchy();
 
+    // Persistent input field, predictions are read in place from the hierarchy
+    util::InputStaging staging;
+    staging.create(h, { ogmaneo::Vec2i(1, 1) });
+
+    ogmaneo::ValueField2D &inputField = staging.getInput(0);
+
     if (enableDebugWindow) {
         //debugWindow.catchUnitRanges(false);
         debugWindow.registerHierarchy(res, h);
@@ -161,9 +164,7 @@ int main() {
                     0.7f * std::sin(0.12352f * M_PI * index * 1.5f + 0.2154f) +
                     0.5f * std::sin(0.0612f * M_PI * index * 3.0f - 0.2112f));
 
-            prediction = h->getPredictions()[0];
-
-            float v = prediction.getData()[0];
+            float v = staging.getPredictionData(0)[0];
 
             // Plot target data
             vis::Point p;
@@ -213,16 +214,12 @@ int main() {
             if (!sf::Keyboard::isKeyPressed(sf::Keyboard::T)) {
                 inputField.getData()[0] = value;
 
-                std::vector<ogmaneo::ValueField2D> inputVector = { inputField };
-                h->activate(inputVector);
-                h->learn(inputVector);
+                staging.activate();
+                staging.learn();
             }
             else {
-                prediction = h->getPredictions()[0];
-                inputField.getData()[0] = prediction.getData()[0];
-
-                std::vector<ogmaneo::ValueField2D> inputVector = { inputField };
-                h->activate(inputVector);
+                staging.feedBackPredictions();
+                staging.activate();
             }
 
 #if 0
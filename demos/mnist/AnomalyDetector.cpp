@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "AnomalyDetector.h"
+
+#include <stats/Distance.h>
+
+#include <cstring>
+#include <fstream>
+
+using namespace mnist;
+
+namespace {
+    const char detectorMagic[4] = { 'O', 'N', 'A', 'D' };
+    const uint32_t detectorVersion = 2;
+
+    struct DetectorFile {
+        char _magic[4];
+        uint32_t _version;
+
+        DetectorState _state;
+    };
+}
+
+float mnist::computeAnomalyScore(const float* input, const float* prediction, int size) {
+    return -stats::meanSquaredError(input, prediction, size);
+}
+
+void AnomalyDetector::create(const DetectorParams &params, float initialAverageScore) {
+    _params = params;
+
+    _averageScore = initialAverageScore;
+
+    _scoreStats.create(_params._varianceDecay);
+
+    _successorCount = 0;
+
+    _anomaly = false;
+    _sustainedAnomaly = false;
+    _firstDetection = false;
+}
+
+void AnomalyDetector::setParams(const DetectorParams &params) {
+    DetectorState state = getState();
+    state._sensitivity = params._sensitivity;
+    state._averageDecay = params._averageDecay;
+    state._numSuccessorsRequired = params._numSuccessorsRequired;
+    state._deviations = params._deviations;
+    state._varianceDecay = params._varianceDecay;
+
+    setState(state);
+}
+
+DetectorState AnomalyDetector::getState() const {
+    DetectorState state;
+    state._sensitivity = _params._sensitivity;
+    state._averageDecay = _params._averageDecay;
+    state._numSuccessorsRequired = _params._numSuccessorsRequired;
+    state._deviations = _params._deviations;
+    state._varianceDecay = _params._varianceDecay;
+    state._averageScore = _averageScore;
+    state._scoreMean = static_cast<float>(_scoreStats.getMean());
+    state._scoreVariance = static_cast<float>(_scoreStats.getVariance());
+    state._scoreStatsValid = _scoreStats.isInitialized() ? 1 : 0;
+
+    return state;
+}
+
+void AnomalyDetector::setState(const DetectorState &state) {
+    DetectorParams params;
+    params._sensitivity = state._sensitivity;
+    params._averageDecay = state._averageDecay;
+    params._numSuccessorsRequired = state._numSuccessorsRequired;
+    params._deviations = state._deviations;
+    params._varianceDecay = state._varianceDecay;
+
+    create(params, state._averageScore);
+
+    if (state._scoreStatsValid)
+        _scoreStats.set(state._scoreMean, state._scoreVariance);
+}
+
+float AnomalyDetector::getThreshold() const {
+    // Adaptive once there are training statistics
+    if (_params._deviations > 0.0f && _scoreStats.isInitialized())
+        return static_cast<float>(_scoreStats.getMean() - _params._deviations * _scoreStats.getStdDev());
+
+    return _averageScore * _params._sensitivity;
+}
+
+bool AnomalyDetector::update(float score, bool train) {
+    _anomaly = score < getThreshold();
+
+    // Successor counting
+    if (_anomaly)
+        _successorCount++;
+    else
+        _successorCount = 0;
+
+    bool prevSustainedAnomaly = _sustainedAnomaly;
+
+    _sustainedAnomaly = _successorCount >= _params._numSuccessorsRequired;
+
+    _firstDetection = !prevSustainedAnomaly && _sustainedAnomaly;
+
+    if (train) {
+        _averageScore = _params._averageDecay * _averageScore + (1.0f - _params._averageDecay) * score;
+
+        _scoreStats.add(score);
+    }
+
+    return _firstDetection;
+}
+
+std::string AnomalyDetector::getDetectorFileName(const std::string &hierarchyFileName) {
+    return hierarchyFileName + ".detector";
+}
+
+bool AnomalyDetector::save(const std::string &fileName) const {
+    DetectorFile file;
+    std::memcpy(file._magic, detectorMagic, sizeof(detectorMagic));
+    file._version = detectorVersion;
+    file._state = getState();
+
+    std::ofstream os(fileName, std::ios::binary);
+
+    os.write(reinterpret_cast<const char*>(&file), sizeof(DetectorFile));
+
+    return os.good();
+}
+
+bool AnomalyDetector::load(const std::string &fileName) {
+    std::ifstream is(fileName, std::ios::binary);
+
+    DetectorFile file;
+
+    if (!is.read(reinterpret_cast<char*>(&file), sizeof(DetectorFile)) ||
+        std::memcmp(file._magic, detectorMagic, sizeof(detectorMagic)) != 0 || file._version != detectorVersion)
+        return false;
+
+    setState(file._state);
+
+    return true;
+}
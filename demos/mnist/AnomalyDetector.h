@@ -0,0 +1,127 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stats/RunningStats.h>
+
+#include <string>
+#include <cstdint>
+
+namespace mnist {
+    // Thresholds applied to the per step anomaly score
+    struct DetectorParams {
+        // A step is anomalous when its score falls below the average score times this
+        float _sensitivity;
+
+        // Average score decay, the average is only updated while training
+        float _averageDecay;
+
+        // Consecutive anomalous steps before an anomaly is signalled
+        int _numSuccessorsRequired;
+
+        // When positive, a step is instead anomalous when its score falls this many standard
+        // deviations below the mean training score, adapting the threshold to the score variance
+        float _deviations;
+
+        // Decay of the training score mean and variance used by _deviations
+        float _varianceDecay;
+
+        DetectorParams()
+            : _sensitivity(1.35f), _averageDecay(0.01f), _numSuccessorsRequired(4), _deviations(0.0f), _varianceDecay(0.999f)
+        {}
+    };
+
+    // Settings and trained statistics of a detector, as stored in files
+    struct DetectorState {
+        float _sensitivity;
+        float _averageDecay;
+        int32_t _numSuccessorsRequired;
+        float _deviations;
+        float _varianceDecay;
+
+        float _averageScore;
+
+        // Training score statistics, valid once a training score was seen
+        float _scoreMean;
+        float _scoreVariance;
+        int32_t _scoreStatsValid;
+    };
+
+    static_assert(sizeof(DetectorState) == 36, "DetectorState layout is part of the file formats");
+
+    // Anomaly score of a prediction of size values, the negative mean squared error
+    float computeAnomalyScore(const float* input, const float* prediction, int size);
+
+    // Turns anomaly scores (negative prediction errors) into sustained anomaly flags
+    class AnomalyDetector {
+    private:
+        DetectorParams _params;
+
+        float _averageScore;
+
+        // Mean and variance of the training scores
+        stats::Ewma _scoreStats;
+
+        // Number of anomalously flagged successors
+        int _successorCount;
+
+        bool _anomaly;
+        bool _sustainedAnomaly;
+        bool _firstDetection;
+
+    public:
+        AnomalyDetector()
+            : _averageScore(1.0f), _successorCount(0), _anomaly(false), _sustainedAnomaly(false), _firstDetection(false)
+        {}
+
+        void create(const DetectorParams &params, float initialAverageScore = 1.0f);
+
+        // Change the thresholds, keeping the trained statistics (resets the successor state)
+        void setParams(const DetectorParams &params);
+
+        // Settings and trained statistics. Setting them resets the successor state
+        DetectorState getState() const;
+        void setState(const DetectorState &state);
+
+        // State kept next to a saved hierarchy as fileName.detector
+        static std::string getDetectorFileName(const std::string &hierarchyFileName);
+
+        bool save(const std::string &fileName) const;
+        bool load(const std::string &fileName);
+
+        // Threshold this step's score, then fold it into the average when training.
+        // Returns whether a sustained anomaly started on this step
+        bool update(float score, bool train);
+
+        const DetectorParams &getParams() const {
+            return _params;
+        }
+
+        float getAverageScore() const {
+            return _averageScore;
+        }
+
+        // Scores below this are anomalous
+        float getThreshold() const;
+
+        // Whether this step's score was below the threshold
+        bool isAnomaly() const {
+            return _anomaly;
+        }
+
+        // Whether enough successive steps were anomalous
+        bool isSustainedAnomaly() const {
+            return _sustainedAnomaly;
+        }
+
+        bool isFirstDetection() const {
+            return _firstDetection;
+        }
+    };
+}
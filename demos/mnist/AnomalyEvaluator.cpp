@@ -0,0 +1,182 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "AnomalyEvaluator.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+
+using namespace mnist;
+
+void AnomalyEvaluator::create(bool computeRoc) {
+    _computeRoc = computeRoc;
+
+    reset();
+}
+
+void AnomalyEvaluator::reset() {
+    _ratios.clear();
+    _inRange.clear();
+
+    _numSteps = 0;
+    _numDigits = 0;
+
+    _numTruePositives = 0;
+    _numFalsePositives = 0;
+
+    _numEpisodes = 0;
+    _numDetectedEpisodes = 0;
+
+    _latencySum = 0;
+
+    _inEpisode = false;
+    _episodeDetected = false;
+    _episodeStart = 0;
+
+    _roc.clear();
+    _auc = 0.0f;
+}
+
+void AnomalyEvaluator::record(float score, float averageScore, bool anomalyInRange, bool firstDetection) {
+    int step = _numSteps++;
+
+    // Scores are negative errors, so with a negative average a larger ratio is more anomalous
+    // and the detector's test (score < average * sensitivity) becomes ratio > sensitivity
+    if (_computeRoc) {
+        _ratios.push_back(averageScore != 0.0f ? score / averageScore : 0.0f);
+        _inRange.push_back(anomalyInRange ? 1 : 0);
+    }
+
+    if (anomalyInRange && !_inEpisode) {
+        _inEpisode = true;
+        _episodeDetected = false;
+        _episodeStart = step;
+
+        _numEpisodes++;
+    }
+    else if (!anomalyInRange)
+        _inEpisode = false;
+
+    if (firstDetection) {
+        if (anomalyInRange) {
+            _numTruePositives++;
+
+            if (!_episodeDetected) {
+                _episodeDetected = true;
+
+                _numDetectedEpisodes++;
+
+                _latencySum += step - _episodeStart;
+            }
+        }
+        else
+            _numFalsePositives++;
+    }
+}
+
+void AnomalyEvaluator::finish() {
+    _inEpisode = false;
+
+    _roc.clear();
+    _auc = 0.0f;
+
+    if (!_computeRoc)
+        return;
+
+    int numSteps = static_cast<int>(_ratios.size());
+
+    int numPositives = 0;
+
+    for (unsigned char r : _inRange)
+        numPositives += r;
+
+    int numNegatives = numSteps - numPositives;
+
+    // Most anomalous steps first, every distinct ratio is one operating point
+    std::vector<int> order(numSteps);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return _ratios[a] > _ratios[b];
+    });
+
+    RocPoint point;
+    point._sensitivity = std::numeric_limits<float>::infinity();
+    point._falsePositiveRate = 0.0f;
+    point._truePositiveRate = 0.0f;
+
+    _roc.push_back(point);
+
+    int truePositives = 0;
+    int falsePositives = 0;
+
+    for (int i = 0; i < numSteps; i++) {
+        if (_inRange[order[i]])
+            truePositives++;
+        else
+            falsePositives++;
+
+        if (i + 1 < numSteps && _ratios[order[i + 1]] == _ratios[order[i]])
+            continue;
+
+        point._sensitivity = _ratios[order[i]];
+        point._falsePositiveRate = numNegatives > 0 ? static_cast<float>(falsePositives) / numNegatives : 0.0f;
+        point._truePositiveRate = numPositives > 0 ? static_cast<float>(truePositives) / numPositives : 0.0f;
+
+        // Trapezoid under the segment from the previous point
+        const RocPoint &prev = _roc.back();
+
+        _auc += (point._falsePositiveRate - prev._falsePositiveRate) * (point._truePositiveRate + prev._truePositiveRate) * 0.5f;
+
+        _roc.push_back(point);
+    }
+}
+
+float AnomalyEvaluator::getPrecision() const {
+    int numDetections = _numTruePositives + _numFalsePositives;
+
+    return numDetections > 0 ? static_cast<float>(_numTruePositives) / numDetections : 0.0f;
+}
+
+float AnomalyEvaluator::getRecall() const {
+    return _numEpisodes > 0 ? static_cast<float>(_numDetectedEpisodes) / _numEpisodes : 0.0f;
+}
+
+float AnomalyEvaluator::getMeanLatency() const {
+    if (_numDetectedEpisodes == 0 || _numDigits == 0)
+        return 0.0f;
+
+    float stepsPerDigit = static_cast<float>(getNumSteps()) / _numDigits;
+
+    return static_cast<float>(_latencySum) / _numDetectedEpisodes / stepsPerDigit;
+}
+
+void AnomalyEvaluator::writeReport(std::ostream &os) const {
+    os << "Digits: " << _numDigits << " (" << getNumSteps() << " steps)" << std::endl;
+    os << "Anomaly episodes: " << _numEpisodes << ", detected " << _numDetectedEpisodes << std::endl;
+    os << "True positives: " << _numTruePositives << ", false positives: " << _numFalsePositives << std::endl;
+
+    os << std::fixed << std::setprecision(4);
+    os << "Precision: " << getPrecision() << std::endl;
+    os << "Recall: " << getRecall() << std::endl;
+    os << "Mean detection latency: " << getMeanLatency() << " digits" << std::endl;
+
+    if (_computeRoc)
+        os << "Per step ROC AUC: " << getAUC() << std::endl;
+
+    os << std::defaultfloat;
+}
+
+void AnomalyEvaluator::writeRoc(std::ostream &os) const {
+    os << "sensitivity,fpr,tpr" << std::endl;
+
+    for (const RocPoint &point : _roc)
+        os << point._sensitivity << "," << point._falsePositiveRate << "," << point._truePositiveRate << std::endl;
+}
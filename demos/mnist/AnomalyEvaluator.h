@@ -0,0 +1,123 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+namespace mnist {
+    // One operating point of the ROC curve
+    struct RocPoint {
+        // Steps are flagged when their score is at least this many times the average score
+        float _sensitivity;
+
+        float _falsePositiveRate;
+        float _truePositiveRate;
+    };
+
+    // Scores a detection run. An episode is a run of steps with an anomalous digit within range
+    // of the center of the screen. It is detected when a sustained anomaly starts during it, and
+    // its latency is the time from the episode start to that detection. Detections starting
+    // outside every episode are false positives. The ROC curve is over single steps, sweeping
+    // the sensitivity with no successors required
+    class AnomalyEvaluator {
+    private:
+        bool _computeRoc;
+
+        // Score over average score, and whether an anomaly was in range, of every step (kept for the ROC curve)
+        std::vector<float> _ratios;
+        std::vector<unsigned char> _inRange;
+
+        int _numSteps;
+        int _numDigits;
+
+        int _numTruePositives;
+        int _numFalsePositives;
+
+        int _numEpisodes;
+        int _numDetectedEpisodes;
+
+        // Summed detection latency in steps
+        long long _latencySum;
+
+        bool _inEpisode;
+        bool _episodeDetected;
+        int _episodeStart;
+
+        std::vector<RocPoint> _roc;
+        float _auc;
+
+    public:
+        AnomalyEvaluator()
+            : _computeRoc(true)
+        {
+            reset();
+        }
+
+        // Without the ROC curve no per step data is kept, for scoring many runs cheaply
+        void create(bool computeRoc);
+
+        void reset();
+
+        // A new digit entered the stream
+        void addDigit() {
+            _numDigits++;
+        }
+
+        // Record one detection step
+        void record(float score, float averageScore, bool anomalyInRange, bool firstDetection);
+
+        // Close the last episode and compute the ROC curve (if enabled)
+        void finish();
+
+        int getNumSteps() const {
+            return _numSteps;
+        }
+
+        int getNumDigits() const {
+            return _numDigits;
+        }
+
+        int getNumTruePositives() const {
+            return _numTruePositives;
+        }
+
+        int getNumFalsePositives() const {
+            return _numFalsePositives;
+        }
+
+        int getNumEpisodes() const {
+            return _numEpisodes;
+        }
+
+        int getNumDetectedEpisodes() const {
+            return _numDetectedEpisodes;
+        }
+
+        float getPrecision() const;
+        float getRecall() const;
+
+        // Mean latency of detected episodes, in digits
+        float getMeanLatency() const;
+
+        const std::vector<RocPoint> &getRoc() const {
+            return _roc;
+        }
+
+        // Area under the ROC curve
+        float getAUC() const {
+            return _auc;
+        }
+
+        void writeReport(std::ostream &os) const;
+
+        // sensitivity,fpr,tpr per line, from the strictest sensitivity down
+        void writeRoc(std::ostream &os) const;
+    };
+}
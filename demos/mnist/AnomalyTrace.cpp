@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "AnomalyTrace.h"
+
+#include <cstring>
+
+using namespace mnist;
+
+namespace {
+    const char traceMagic[4] = { 'O', 'N', 'A', 'T' };
+}
+
+bool AnomalyTraceWriter::create(const std::string &fileName, const AnomalyDetector &detector) {
+    close();
+
+    _file = std::fopen(fileName.c_str(), "wb");
+
+    if (_file == nullptr)
+        return false;
+
+    AnomalyTraceHeader header;
+    std::memcpy(header._magic, traceMagic, sizeof(traceMagic));
+    header._version = _version;
+    header._recordSize = sizeof(AnomalyTraceRecord);
+    header._initialState = detector.getState();
+
+    if (std::fwrite(&header, sizeof(AnomalyTraceHeader), 1, _file) != 1) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void AnomalyTraceWriter::close() {
+    if (_file == nullptr)
+        return;
+
+    std::fclose(_file);
+    _file = nullptr;
+}
+
+void AnomalyTraceWriter::record(float score, bool train, bool anomalyInRange, bool newDigit) {
+    AnomalyTraceRecord record;
+    record._score = score;
+    record._flags = (train ? AnomalyTraceRecord::_train : 0) |
+        (anomalyInRange ? AnomalyTraceRecord::_anomalyInRange : 0) |
+        (newDigit ? AnomalyTraceRecord::_newDigit : 0);
+
+    std::fwrite(&record, sizeof(AnomalyTraceRecord), 1, _file);
+}
+
+bool AnomalyTraceReader::open(const std::string &fileName) {
+    _numRecords = 0;
+
+    if (!_file.open(fileName, true))
+        return false;
+
+    if (_file.getSize() < sizeof(AnomalyTraceHeader)) {
+        _file.close();
+        return false;
+    }
+
+    const AnomalyTraceHeader &header = getHeader();
+
+    if (std::memcmp(header._magic, traceMagic, sizeof(traceMagic)) != 0 ||
+        header._version != AnomalyTraceWriter::_version || header._recordSize != sizeof(AnomalyTraceRecord))
+    {
+        _file.close();
+        return false;
+    }
+
+    _numRecords = (_file.getSize() - sizeof(AnomalyTraceHeader)) / sizeof(AnomalyTraceRecord);
+
+    return true;
+}
+
+DetectorParams AnomalyTraceReader::getRecordedParams() const {
+    AnomalyDetector detector;
+    detector.setState(getHeader()._initialState);
+
+    return detector.getParams();
+}
+
+void mnist::replayTrace(const AnomalyTraceReader &trace, const DetectorParams &params, AnomalyEvaluator &evaluator) {
+    AnomalyDetector detector;
+    detector.setState(trace.getHeader()._initialState);
+    detector.setParams(params);
+
+    evaluator.reset();
+
+    for (size_t i = 0; i < trace.getNumRecords(); i++) {
+        const AnomalyTraceRecord &record = trace.getRecord(i);
+
+        bool train = (record._flags & AnomalyTraceRecord::_train) != 0;
+
+        detector.update(record._score, train);
+
+        if (train)
+            continue;
+
+        if (record._flags & AnomalyTraceRecord::_newDigit)
+            evaluator.addDigit();
+
+        evaluator.record(record._score, detector.getAverageScore(), (record._flags & AnomalyTraceRecord::_anomalyInRange) != 0,
+            detector.isFirstDetection());
+    }
+
+    evaluator.finish();
+}
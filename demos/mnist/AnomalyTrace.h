@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/MappedFile.h>
+
+#include "AnomalyDetector.h"
+#include "AnomalyEvaluator.h"
+
+#include <cstdio>
+#include <string>
+#include <cstdint>
+
+namespace mnist {
+    // One simulation step, stored as is in the trace file
+    struct AnomalyTraceRecord {
+        // Negative mean squared prediction error
+        float _score;
+
+        uint32_t _flags;
+
+        enum {
+            _train = 1,
+            _anomalyInRange = 2,
+            _newDigit = 4
+        };
+    };
+
+    static_assert(sizeof(AnomalyTraceRecord) == 8, "AnomalyTraceRecord layout is part of the file format");
+
+    struct AnomalyTraceHeader {
+        char _magic[4];
+        uint32_t _version;
+        uint32_t _recordSize;
+
+        // Detector the trace was recorded with, as it was when recording started
+        DetectorState _initialState;
+    };
+
+    static_assert(sizeof(AnomalyTraceHeader) % sizeof(AnomalyTraceRecord) == 0, "Records follow the header aligned");
+
+    // Raw per step anomaly scores of a run, training steps included (the average score is only
+    // updated while training), so detector settings can be replayed without the hierarchy
+    class AnomalyTraceWriter {
+    private:
+        std::FILE* _file;
+
+    public:
+        static const uint32_t _version = 2;
+
+        AnomalyTraceWriter()
+            : _file(nullptr)
+        {}
+
+        ~AnomalyTraceWriter() {
+            close();
+        }
+
+        // Create (replacing) a trace of a run starting from the detector's current state
+        bool create(const std::string &fileName, const AnomalyDetector &detector);
+
+        void close();
+
+        bool isOpen() const {
+            return _file != nullptr;
+        }
+
+        void record(float score, bool train, bool anomalyInRange, bool newDigit);
+    };
+
+    // Memory mapped view of a trace. A partially written last record is ignored
+    class AnomalyTraceReader {
+    private:
+        util::MappedFile _file;
+
+        size_t _numRecords;
+
+    public:
+        AnomalyTraceReader()
+            : _numRecords(0)
+        {}
+
+        bool open(const std::string &fileName);
+
+        const AnomalyTraceHeader &getHeader() const {
+            return *reinterpret_cast<const AnomalyTraceHeader*>(_file.getData());
+        }
+
+        // Detector settings the trace was recorded with
+        DetectorParams getRecordedParams() const;
+
+        size_t getNumRecords() const {
+            return _numRecords;
+        }
+
+        const AnomalyTraceRecord &getRecord(size_t index) const {
+            return reinterpret_cast<const AnomalyTraceRecord*>(_file.getData() + sizeof(AnomalyTraceHeader))[index];
+        }
+    };
+
+    // Run a detector with params over a trace, scoring its detection steps with evaluator (which is reset first)
+    void replayTrace(const AnomalyTraceReader &trace, const DetectorParams &params, AnomalyEvaluator &evaluator);
+}
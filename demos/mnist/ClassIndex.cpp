@@ -0,0 +1,143 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "ClassIndex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+using namespace mnist;
+
+namespace {
+    const char indexMagic[4] = { 'O', 'N', 'C', 'I' };
+    const uint32_t indexVersion = 1;
+
+    // Labels are bytes
+    const int maxClasses = 256;
+}
+
+std::string ClassIndex::getIndexFileName(const std::string &labelsFileName) {
+    return labelsFileName + ".classindex";
+}
+
+bool ClassIndex::load(const MnistDataset &dataset) {
+    video::SourceStamp source;
+
+    if (!source.fromFile(dataset.getLabelsFileName()))
+        return false;
+
+    std::ifstream fromFile(getIndexFileName(dataset.getLabelsFileName()), std::ios::binary | std::ios::in);
+
+    if (!fromFile.is_open())
+        return false;
+
+    char magic[4];
+    uint32_t version;
+    video::SourceStamp fileSource;
+    int32_t numClasses, numSamples;
+
+    fromFile.read(magic, sizeof(magic));
+    fromFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+    fromFile.read(reinterpret_cast<char*>(&fileSource), sizeof(fileSource));
+    fromFile.read(reinterpret_cast<char*>(&numClasses), sizeof(numClasses));
+    fromFile.read(reinterpret_cast<char*>(&numSamples), sizeof(numSamples));
+
+    if (!fromFile.good() || std::memcmp(magic, indexMagic, sizeof(magic)) != 0 || version != indexVersion ||
+        fileSource != source || numClasses <= 0 || numClasses > maxClasses || numSamples != dataset.getNumDigits())
+        return false;
+
+    _classStarts.resize(numClasses + 1);
+    _samples.resize(numSamples);
+
+    fromFile.read(reinterpret_cast<char*>(_classStarts.data()), sizeof(int) * _classStarts.size());
+    fromFile.read(reinterpret_cast<char*>(_samples.data()), sizeof(int) * _samples.size());
+
+    // A matching stamp does not vouch for the index itself, an edited or torn one must not index out of range
+    bool valid = fromFile.good() && _classStarts.front() == 0 && _classStarts.back() == numSamples;
+
+    for (int c = 0; valid && c < numClasses; c++)
+        valid = _classStarts[c] <= _classStarts[c + 1];
+
+    for (int i = 0; valid && i < numSamples; i++)
+        valid = _samples[i] >= 0 && _samples[i] < numSamples;
+
+    if (!valid) {
+        _classStarts.clear();
+        _samples.clear();
+
+        return false;
+    }
+
+    _source = source;
+
+    return true;
+}
+
+bool ClassIndex::save(const std::string &labelsFileName) const {
+    std::ofstream toFile(getIndexFileName(labelsFileName), std::ios::binary | std::ios::out | std::ios::trunc);
+
+    if (!toFile.is_open())
+        return false;
+
+    int32_t numClasses = getNumClasses();
+    int32_t numSamples = static_cast<int32_t>(_samples.size());
+
+    toFile.write(indexMagic, sizeof(indexMagic));
+    toFile.write(reinterpret_cast<const char*>(&indexVersion), sizeof(indexVersion));
+    toFile.write(reinterpret_cast<const char*>(&_source), sizeof(_source));
+    toFile.write(reinterpret_cast<const char*>(&numClasses), sizeof(numClasses));
+    toFile.write(reinterpret_cast<const char*>(&numSamples), sizeof(numSamples));
+    toFile.write(reinterpret_cast<const char*>(_classStarts.data()), sizeof(int) * _classStarts.size());
+    toFile.write(reinterpret_cast<const char*>(_samples.data()), sizeof(int) * _samples.size());
+
+    return toFile.good();
+}
+
+void ClassIndex::build(const MnistDataset &dataset) {
+    _source = video::SourceStamp();
+    _source.fromFile(dataset.getLabelsFileName());
+
+    const int numSamples = dataset.getNumDigits();
+
+    // Counting sort: class sizes, then each sample placed at its class's next slot
+    std::vector<int> counts(maxClasses, 0);
+
+    int numClasses = 0;
+
+    for (int i = 0; i < numSamples; i++) {
+        int label = dataset.getLabel(i);
+
+        counts[label]++;
+
+        numClasses = std::max(numClasses, label + 1);
+    }
+
+    _classStarts.assign(numClasses + 1, 0);
+
+    for (int c = 0; c < numClasses; c++)
+        _classStarts[c + 1] = _classStarts[c] + counts[c];
+
+    _samples.resize(numSamples);
+
+    std::vector<int> next(_classStarts.begin(), _classStarts.end() - 1);
+
+    for (int i = 0; i < numSamples; i++)
+        _samples[next[dataset.getLabel(i)]++] = i;
+}
+
+void ClassIndex::loadOrBuild(const MnistDataset &dataset) {
+    if (load(dataset))
+        return;
+
+    build(dataset);
+
+    // A read-only resources directory only costs a rebuild next run
+    save(dataset.getLabelsFileName());
+}
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <video/SourceStamp.h>
+
+#include "MnistDataset.h"
+
+#include <string>
+#include <vector>
+
+namespace mnist {
+    // Sample indices of every class, built in one pass over the labels and persisted in a sidecar
+    // next to the labels file. Samples are grouped by class, in file order within a class
+    class ClassIndex {
+    private:
+        video::SourceStamp _source;
+
+        // Start of each class in _samples, numClasses + 1 entries
+        std::vector<int> _classStarts;
+
+        std::vector<int> _samples;
+
+    public:
+        static std::string getIndexFileName(const std::string &labelsFileName);
+
+        // Load an existing index, fails if it is missing, the labels have changed or it does not match the dataset
+        bool load(const MnistDataset &dataset);
+
+        bool save(const std::string &labelsFileName) const;
+
+        void build(const MnistDataset &dataset);
+
+        // Load the sidecar if present and current, otherwise build and save it
+        void loadOrBuild(const MnistDataset &dataset);
+
+        int getNumClasses() const {
+            return static_cast<int>(_classStarts.size()) - 1;
+        }
+
+        int getClassSize(int label) const {
+            return label < getNumClasses() ? _classStarts[label + 1] - _classStarts[label] : 0;
+        }
+
+        // Dataset index of the i'th sample of a class
+        int getSample(int label, int i) const {
+            return _samples[_classStarts[label] + i];
+        }
+    };
+}
@@ -0,0 +1,104 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "DigitCompositor.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mnist;
+
+namespace {
+    const float pi = 3.14159265358979f;
+
+    // Coverage of texel (x, y) in [0, 1], zero outside the digit
+    inline float texel(const unsigned char* intensities, int width, int height, int x, int y) {
+        if (x < 0 || y < 0 || x >= width || y >= height)
+            return 0.0f;
+
+        return intensities[x + y * width] * (1.0f / 255.0f);
+    }
+}
+
+void DigitCompositor::create(int width, int height, int angleSteps) {
+    _width = width;
+    _height = height;
+
+    _cos.resize(angleSteps);
+    _sin.resize(angleSteps);
+
+    for (int a = 0; a < angleSteps; a++) {
+        float radians = a * 2.0f * pi / angleSteps;
+
+        _cos[a] = std::cos(radians);
+        _sin[a] = std::sin(radians);
+    }
+}
+
+void DigitCompositor::clear(float* field) const {
+    std::fill(field, field + _width * _height, 0.0f);
+}
+
+void DigitCompositor::draw(float* field, const unsigned char* intensities, int digitWidth, int digitHeight,
+    float centerX, float centerY, float degrees) const
+{
+    const int angleSteps = static_cast<int>(_cos.size());
+
+    int angle = static_cast<int>(std::floor(degrees * angleSteps / 360.0f + 0.5f)) % angleSteps;
+
+    if (angle < 0)
+        angle += angleSteps;
+
+    float c = _cos[angle];
+    float s = _sin[angle];
+
+    // Bounding circle of the rotated digit, clipped to the field
+    float radius = 0.5f * std::sqrt(static_cast<float>(digitWidth * digitWidth + digitHeight * digitHeight)) + 1.0f;
+
+    int x0 = std::max(0, static_cast<int>(std::floor(centerX - radius)));
+    int y0 = std::max(0, static_cast<int>(std::floor(centerY - radius)));
+    int x1 = std::min(_width, static_cast<int>(std::ceil(centerX + radius)));
+    int y1 = std::min(_height, static_cast<int>(std::ceil(centerY + radius)));
+
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    // Digit texel coordinates (texel centers at integers) of a field pixel center, stepping by the inverse rotation
+    float originU = 0.5f * digitWidth - 0.5f;
+    float originV = 0.5f * digitHeight - 0.5f;
+
+    for (int y = y0; y < y1; y++) {
+        float dx = x0 + 0.5f - centerX;
+        float dy = y + 0.5f - centerY;
+
+        float u = originU + c * dx + s * dy;
+        float v = originV - s * dx + c * dy;
+
+        float* row = field + y * _width;
+
+        for (int x = x0; x < x1; x++, u += c, v -= s) {
+            if (u <= -1.0f || v <= -1.0f || u >= digitWidth || v >= digitHeight)
+                continue;
+
+            int iu = static_cast<int>(std::floor(u));
+            int iv = static_cast<int>(std::floor(v));
+
+            float fu = u - iu;
+            float fv = v - iv;
+
+            float top = texel(intensities, digitWidth, digitHeight, iu, iv) * (1.0f - fu) +
+                texel(intensities, digitWidth, digitHeight, iu + 1, iv) * fu;
+            float bottom = texel(intensities, digitWidth, digitHeight, iu, iv + 1) * (1.0f - fu) +
+                texel(intensities, digitWidth, digitHeight, iu + 1, iv + 1) * fu;
+
+            float a = top * (1.0f - fv) + bottom * fv;
+
+            row[x] = a + row[x] * (1.0f - a);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+namespace mnist {
+    // CPU compositor of rotated digits into a float field, in place of drawing sprites into a render
+    // texture and reading it back. Digits are white with their intensity as coverage, blended over
+    // the field (field = a + field * (1 - a)) like alpha blended sprites on a black target.
+    // Rotations follow SFML (degrees, clockwise on screen) and come from a table of angleSteps
+    // angles per turn. Digits are sampled bilinearly, transparent outside their bounds
+    class DigitCompositor {
+    private:
+        int _width, _height;
+
+        std::vector<float> _cos;
+        std::vector<float> _sin;
+
+    public:
+        DigitCompositor()
+            : _width(0), _height(0)
+        {}
+
+        // Field of width x height (row major)
+        void create(int width, int height, int angleSteps = 360);
+
+        void clear(float* field) const;
+
+        // Blend a digitWidth x digitHeight digit (8-bit intensities) centered at (centerX, centerY), rotated by degrees
+        void draw(float* field, const unsigned char* intensities, int digitWidth, int digitHeight,
+            float centerX, float centerY, float degrees) const;
+    };
+}
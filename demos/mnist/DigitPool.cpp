@@ -0,0 +1,41 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "DigitPool.h"
+
+#include <algorithm>
+
+using namespace mnist;
+
+void DigitPool::create(int capacity, int width, int height) {
+    _ring.create(capacity);
+
+    _width = width;
+    _height = height;
+
+    _intensities.assign(capacity * _width * _height, 0);
+
+    _spins.assign(capacity, 0.0f);
+    _anomalous.assign(capacity, 0);
+    _labels.assign(capacity, 0);
+}
+
+void DigitPool::push(const unsigned char* intensities, int label, bool anomalous) {
+    int slot = _ring.pushFront();
+
+    std::copy(intensities, intensities + _width * _height, _intensities.begin() + slot * _width * _height);
+
+    _spins[slot] = 0.0f;
+    _anomalous[slot] = anomalous ? 1 : 0;
+    _labels[slot] = label;
+}
+
+void DigitPool::spin(float rate) {
+    for (float &s : _spins)
+        s += rate;
+}
@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/RingIndex.h>
+
+#include <vector>
+
+namespace mnist {
+    // The digits moving across the screen, newest first. Per digit fields are stored as separate
+    // arrays indexed through a RingIndex, and each slot owns preallocated pixel storage that is
+    // overwritten in place when the slot is recycled for a new digit
+    class DigitPool {
+    private:
+        util::RingIndex _ring;
+
+        int _width, _height;
+
+        // width * height intensities per slot
+        std::vector<unsigned char> _intensities;
+
+        std::vector<float> _spins;
+        std::vector<unsigned char> _anomalous;
+        std::vector<int> _labels;
+
+    public:
+        DigitPool()
+            : _width(0), _height(0)
+        {}
+
+        void create(int capacity, int width, int height);
+
+        // Add a digit (width * height intensities) as the newest, recycling the oldest slot when full
+        void push(const unsigned char* intensities, int label, bool anomalous);
+
+        // Advance every digit's rotation
+        void spin(float rate);
+
+        int size() const {
+            return _ring.size();
+        }
+
+        int getCapacity() const {
+            return _ring.getCapacity();
+        }
+
+        int getWidth() const {
+            return _width;
+        }
+
+        int getHeight() const {
+            return _height;
+        }
+
+        // Fields of the i'th newest digit
+        const unsigned char* getIntensities(int i) const {
+            return _intensities.data() + _ring.getSlot(i) * _width * _height;
+        }
+
+        float getSpin(int i) const {
+            return _spins[_ring.getSlot(i)];
+        }
+
+        bool isAnomalous(int i) const {
+            return _anomalous[_ring.getSlot(i)] != 0;
+        }
+
+        int getLabel(int i) const {
+            return _labels[_ring.getSlot(i)];
+        }
+    };
+}
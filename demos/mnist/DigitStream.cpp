@@ -0,0 +1,122 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "DigitStream.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace mnist;
+
+bool DigitStream::create(const MnistDataset &dataset, const ClassIndex &classIndex, const DigitStreamParams &params, unsigned int seed) {
+    _dataset = &dataset;
+    _classIndex = &classIndex;
+    _params = params;
+
+    _generator.seed(seed);
+
+    _anomalousLabels.clear();
+
+    for (int c = 0; c < classIndex.getNumClasses(); c++)
+        if (c != _params._targetLabel && classIndex.getClassSize(c) > 0)
+            _anomalousLabels.push_back(c);
+
+    if (classIndex.getClassSize(_params._targetLabel) == 0 || _anomalousLabels.empty()) {
+        std::cerr << "MNIST has no digits of " << (_anomalousLabels.empty() ? "any other" : "the target") << " class" << std::endl;
+
+        return false;
+    }
+
+    _anomalousPerClass = (_params._totalAnomalous + static_cast<int>(_anomalousLabels.size()) - 1) / static_cast<int>(_anomalousLabels.size());
+
+    _pool.create(_params._poolSize, dataset.getWidth(), dataset.getHeight());
+
+    // Load first digits
+    for (int i = 0; i < _pool.getCapacity(); i++) {
+        int digitIndex = sampleMain();
+
+        _pool.push(dataset.getImage(digitIndex), dataset.getLabel(digitIndex), false);
+    }
+
+    _position = 0.0f;
+
+    return true;
+}
+
+int DigitStream::sampleMain() {
+    std::uniform_int_distribution<int> sampleDist(0, std::min(_params._totalMain, _classIndex->getClassSize(_params._targetLabel)) - 1);
+
+    return _classIndex->getSample(_params._targetLabel, sampleDist(_generator));
+}
+
+int DigitStream::sampleAnomalous() {
+    std::uniform_int_distribution<int> labelDist(0, static_cast<int>(_anomalousLabels.size()) - 1);
+
+    int label = _anomalousLabels[labelDist(_generator)];
+
+    std::uniform_int_distribution<int> sampleDist(0, std::min(_anomalousPerClass, _classIndex->getClassSize(label)) - 1);
+
+    return _classIndex->getSample(label, sampleDist(_generator));
+}
+
+bool DigitStream::advance(bool allowAnomalies) {
+    bool newDigit = false;
+
+    // Move digits
+    _position += _params._moveSpeed;
+
+    // If new digit needs to be loaded
+    if (_position > _params._spacing) {
+        // Pick digit, get anomalous status
+        bool anomalous = false;
+
+        int digitIndex;
+
+        if (allowAnomalies && std::uniform_real_distribution<float>(0.0f, 1.0f)(_generator) < _params._anomalyRate) {
+            digitIndex = sampleAnomalous();
+
+            anomalous = true;
+        }
+        else
+            digitIndex = sampleMain();
+
+        // Load new digit into the oldest slot
+        _pool.push(_dataset->getImage(digitIndex), _dataset->getLabel(digitIndex), anomalous);
+
+        newDigit = true;
+
+        // Reset position
+        _position = 0.0f;
+    }
+
+    // Add spinning motion
+    _pool.spin(_params._spinRate);
+
+    return newDigit;
+}
+
+void DigitStream::composite(const DigitCompositor &compositor, float* field, int height) const {
+    compositor.clear(field);
+
+    // Total width of image pool in pixels
+    float offset = -_params._spacing * _pool.size() * 0.5f;
+
+    for (int i = 0; i < _pool.size(); i++)
+        compositor.draw(field, _pool.getIntensities(i), _pool.getWidth(), _pool.getHeight(),
+            offset + _position + i * _params._spacing + _pool.getWidth() * 0.5f, height * 0.5f, _pool.getSpin(i));
+}
+
+bool DigitStream::isAnomalyInRange() const {
+    int center = _pool.getCapacity() / 2;
+
+    for (int dx = -_params._okRange; dx <= _params._okRange; dx++)
+        if (_pool.isAnomalous(center + dx))
+            return true;
+
+    return false;
+}
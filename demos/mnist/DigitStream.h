@@ -0,0 +1,110 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include "MnistDataset.h"
+#include "ClassIndex.h"
+#include "DigitPool.h"
+#include "DigitCompositor.h"
+
+#include <random>
+#include <vector>
+
+namespace mnist {
+    struct DigitStreamParams {
+        // Speed digits move across the screen
+        float _moveSpeed;
+
+        // Spacing between digits
+        float _spacing;
+
+        // Label of non-anomalous class
+        int _targetLabel;
+
+        // Amount of target (main) digits used
+        int _totalMain;
+
+        // Amount of anomalous digits used, spread evenly over the other classes
+        int _totalAnomalous;
+
+        // Ratio of time which anomalies randomly appear
+        float _anomalyRate;
+
+        // Offscreen digit pool buffer size
+        int _poolSize;
+
+        // How fast the digits spin
+        float _spinRate;
+
+        // Approximate range (in digits) where an anomaly flag can be compared to the actual anomaly outcome
+        int _okRange;
+
+        DigitStreamParams()
+            : _moveSpeed(1.0f), _spacing(28.0f), _targetLabel(3), _totalMain(5), _totalAnomalous(2000), _anomalyRate(0.1f),
+            _poolSize(20), _spinRate(5.0f), _okRange(1)
+        {}
+    };
+
+    // A row of spinning MNIST digits scrolling past the center of the input, fed from its own
+    // random number generator. Several streams can share a dataset, class index and compositor
+    class DigitStream {
+    private:
+        const MnistDataset* _dataset;
+        const ClassIndex* _classIndex;
+
+        DigitStreamParams _params;
+
+        std::mt19937 _generator;
+
+        // Anomalies are drawn evenly from the other classes
+        std::vector<int> _anomalousLabels;
+
+        // Digits used of each anomalous class
+        int _anomalousPerClass;
+
+        DigitPool _pool;
+
+        // Offset of the newest digit
+        float _position;
+
+        int sampleMain();
+        int sampleAnomalous();
+
+    public:
+        DigitStream()
+            : _dataset(nullptr), _classIndex(nullptr), _anomalousPerClass(0), _position(0.0f)
+        {}
+
+        // Fill the pool with target digits. Fails if the target class or every other class is empty
+        bool create(const MnistDataset &dataset, const ClassIndex &classIndex, const DigitStreamParams &params, unsigned int seed);
+
+        // Restart the digit sequence, without touching the digits already in the pool
+        void seed(unsigned int seed) {
+            _generator.seed(seed);
+        }
+
+        // Move the digits one step, anomalous digits only appear when allowed.
+        // Returns whether a new digit entered the stream
+        bool advance(bool allowAnomalies);
+
+        // Draw the digits into the compositor's field, centered vertically on a field of the given height
+        void composite(const DigitCompositor &compositor, float* field, int height) const;
+
+        // Whether an anomalous digit is within range of the center
+        bool isAnomalyInRange() const;
+
+        const DigitPool &getPool() const {
+            return _pool;
+        }
+
+        const DigitStreamParams &getParams() const {
+            return _params;
+        }
+    };
+}
@@ -0,0 +1,160 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "IdxFile.h"
+
+#include <algorithm>
+#include <iostream>
+
+#if defined(DEMOS_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+using namespace mnist;
+
+namespace {
+    // Unsigned byte element type in the third magic byte
+    const unsigned char idxTypeUByte = 0x08;
+
+    int readBigEndian(const unsigned char* bytes) {
+        return static_cast<int>((static_cast<unsigned int>(bytes[0]) << 24) | (static_cast<unsigned int>(bytes[1]) << 16) |
+            (static_cast<unsigned int>(bytes[2]) << 8) | static_cast<unsigned int>(bytes[3]));
+    }
+
+    bool endsWith(const std::string &s, const std::string &suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+size_t IdxFile::parseHeader(const unsigned char* data, size_t size, int numDims, const std::string &fileName) {
+    size_t headerSize = 4 + 4 * static_cast<size_t>(numDims);
+
+    if (size < headerSize || data[0] != 0 || data[1] != 0 || data[2] != idxTypeUByte || data[3] != numDims) {
+        std::cerr << "Not an unsigned byte IDX file of " << numDims << " dimensions: " << fileName << std::endl;
+        return 0;
+    }
+
+    _dims.resize(numDims);
+    _itemSize = 1;
+
+    for (int d = 0; d < numDims; d++) {
+        _dims[d] = readBigEndian(data + 4 + 4 * d);
+
+        if (_dims[d] <= 0) {
+            std::cerr << "Invalid IDX dimension " << d << " (" << _dims[d] << "): " << fileName << std::endl;
+            return 0;
+        }
+
+        if (d > 0)
+            _itemSize *= _dims[d];
+    }
+
+    return headerSize;
+}
+
+bool IdxFile::open(const std::string &fileName, int numDims) {
+    close();
+
+    if (endsWith(fileName, ".gz"))
+        return openGzip(fileName, numDims);
+
+    if (!_mapped.open(fileName))
+        return false;
+
+    size_t headerSize = parseHeader(_mapped.getData(), _mapped.getSize(), numDims, fileName);
+
+    if (headerSize == 0) {
+        close();
+        return false;
+    }
+
+    if (_mapped.getSize() < headerSize + _itemSize * getNumItems()) {
+        std::cerr << "IDX file is truncated (" << _mapped.getSize() << " bytes for " << getNumItems() << " items): " << fileName << std::endl;
+
+        close();
+        return false;
+    }
+
+    _items = _mapped.getData() + headerSize;
+
+    return true;
+}
+
+bool IdxFile::openGzip(const std::string &fileName, int numDims) {
+#if defined(DEMOS_HAVE_ZLIB)
+    gzFile file = gzopen(fileName.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    gzbuffer(file, 1 << 16);
+
+    // The header gives the inflated size, so the contents are inflated straight into one allocation
+    unsigned char header[4 + 4 * 4];
+
+    int headerSize = 4 + 4 * std::min(numDims, 4);
+
+    if (numDims > 4 || gzread(file, header, headerSize) != headerSize || parseHeader(header, headerSize, numDims, fileName) == 0) {
+        if (numDims > 4)
+            std::cerr << "Unsupported IDX dimensions (" << numDims << "): " << fileName << std::endl;
+
+        gzclose(file);
+
+        close();
+        return false;
+    }
+
+    size_t size = _itemSize * getNumItems();
+
+    _inflated.resize(size);
+
+    const size_t chunkSize = 1 << 20;
+
+    for (size_t offset = 0; offset < size;) {
+        unsigned int request = static_cast<unsigned int>(std::min(chunkSize, size - offset));
+
+        int read = gzread(file, _inflated.data() + offset, request);
+
+        if (read <= 0) {
+            std::cerr << "IDX file is truncated (" << offset << " of " << size << " item bytes): " << fileName << std::endl;
+
+            gzclose(file);
+
+            close();
+            return false;
+        }
+
+        offset += read;
+    }
+
+    gzclose(file);
+
+    _items = _inflated.data();
+
+    return true;
+#else
+    (void)numDims;
+
+    std::cerr << "Built without zlib, extract the file first: " << fileName << std::endl;
+
+    return false;
+#endif
+}
+
+void IdxFile::close() {
+    _mapped.close();
+
+    _inflated.clear();
+    _inflated.shrink_to_fit();
+
+    _items = nullptr;
+
+    _dims.clear();
+
+    _itemSize = 0;
+}
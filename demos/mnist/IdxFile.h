@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/MappedFile.h>
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace mnist {
+    // An IDX file of unsigned bytes (the MNIST format): a magic number, big endian dimensions, then
+    // the items back to back. Plain files are memory mapped and items point straight into the mapping.
+    // Gzipped files (.gz) are inflated in one streaming pass into a single buffer sized from the header
+    class IdxFile {
+    private:
+        util::MappedFile _mapped;
+
+        // Inflated contents of a gzipped file
+        std::vector<unsigned char> _inflated;
+
+        const unsigned char* _items;
+
+        std::vector<int> _dims;
+
+        size_t _itemSize;
+
+        bool openGzip(const std::string &fileName, int numDims);
+
+        // Validate the header against numDims and the available bytes, returns the header size or 0
+        size_t parseHeader(const unsigned char* data, size_t size, int numDims, const std::string &fileName);
+
+    public:
+        IdxFile()
+            : _items(nullptr), _itemSize(0)
+        {}
+
+        IdxFile(const IdxFile &) = delete;
+        IdxFile &operator=(const IdxFile &) = delete;
+
+        // Open a file of numDims dimensions (the first counting items), gzipped if it ends in .gz
+        bool open(const std::string &fileName, int numDims);
+
+        void close();
+
+        bool isOpen() const {
+            return _items != nullptr;
+        }
+
+        bool isCompressed() const {
+            return !_inflated.empty();
+        }
+
+        int getNumItems() const {
+            return _dims.empty() ? 0 : _dims[0];
+        }
+
+        // Size of dimension d, 0 is the item count
+        int getDim(int d) const {
+            return _dims[d];
+        }
+
+        // Bytes per item, the product of the dimensions after the first
+        size_t getItemSize() const {
+            return _itemSize;
+        }
+
+        // Item bytes, valid while the file is open
+        const unsigned char* getItem(int index) const {
+            return _items + index * _itemSize;
+        }
+    };
+}
@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "MnistDataset.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace mnist;
+
+namespace {
+    // First existing file among the naming variants of an MNIST file, empty if none
+    std::string findIdxFile(const std::string &directory, const std::string &set, const std::string &kind, int numDims) {
+        const std::string separators[] = { "-", "." };
+        const std::string suffixes[] = { "", ".gz" };
+
+        for (const std::string &suffix : suffixes)
+            for (const std::string &separator : separators) {
+                std::string fileName = directory + "/" + set + "-" + kind + separator + "idx" + std::to_string(numDims) + "-ubyte" + suffix;
+
+                if (std::ifstream(fileName).is_open())
+                    return fileName;
+            }
+
+        return "";
+    }
+}
+
+bool MnistDataset::open(const std::string &directory, const std::string &set) {
+    std::string imagesFileName = findIdxFile(directory, set, "images", 3);
+    std::string labelsFileName = findIdxFile(directory, set, "labels", 1);
+
+    if (imagesFileName.empty() || labelsFileName.empty()) {
+        std::cerr << "Could not find " << set << "-" << (imagesFileName.empty() ? "images-idx3" : "labels-idx1") << "-ubyte (or .gz) in " << directory << std::endl;
+        return false;
+    }
+
+    if (!_images.open(imagesFileName, 3) || !_labels.open(labelsFileName, 1))
+        return false;
+
+    if (_labels.getNumItems() != _images.getNumItems()) {
+        std::cerr << "MNIST image and label counts differ (" << _images.getNumItems() << " and " << _labels.getNumItems() << ")" << std::endl;
+
+        _images.close();
+        _labels.close();
+
+        return false;
+    }
+
+    _labelsFileName = labelsFileName;
+
+    return true;
+}
@@ -0,0 +1,59 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include "IdxFile.h"
+
+#include <string>
+
+namespace mnist {
+    // MNIST digit images and their labels, read through IdxFile
+    class MnistDataset {
+    private:
+        IdxFile _images;
+        IdxFile _labels;
+
+        std::string _labelsFileName;
+
+    public:
+        // Open <directory>/<set>-images-idx3-ubyte and <set>-labels-idx1-ubyte (set is "train" or "t10k").
+        // The dotted names (<set>-images.idx3-ubyte) and gzipped files (.gz) are found as well
+        bool open(const std::string &directory, const std::string &set = "train");
+
+        int getNumDigits() const {
+            return _images.getNumItems();
+        }
+
+        int getWidth() const {
+            return _images.getDim(2);
+        }
+
+        int getHeight() const {
+            return _images.getDim(1);
+        }
+
+        // Row major 8-bit intensities, valid while the dataset is open
+        const unsigned char* getImage(int index) const {
+            return _images.getItem(index);
+        }
+
+        int getLabel(int index) const {
+            return *_labels.getItem(index);
+        }
+
+        // Labels file found by open, derived files are stamped with it
+        const std::string &getLabelsFileName() const {
+            return _labelsFileName;
+        }
+
+        bool isCompressed() const {
+            return _images.isCompressed() || _labels.isCompressed();
+        }
+    };
+}
@@ -0,0 +1,181 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "Distance.h"
+
+#include <util/Simd.h>
+
+#include <cmath>
+
+namespace {
+#if defined(DEMOS_SIMD_AVX2)
+    inline float horizontalSum(__m256 v) {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+
+        return _mm_cvtss_f32(s);
+    }
+#elif defined(DEMOS_SIMD_NEON)
+    inline float horizontalSum(float32x4_t v) {
+        float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+#endif
+}
+
+float stats::meanSquaredError(const float* a, const float* b, int size) {
+    if (size <= 0)
+        return 0.0f;
+
+    float sum = 0.0f;
+
+    int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+    // Two accumulators hide the FMA latency
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+
+    for (; i + 16 <= size; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+
+    for (; i + 8 <= size; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+
+        sum0 = _mm256_fmadd_ps(d, d, sum0);
+    }
+
+    sum = horizontalSum(_mm256_add_ps(sum0, sum1));
+#elif defined(DEMOS_SIMD_NEON)
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= size; i += 8) {
+        float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+
+        sum0 = vmlaq_f32(sum0, d0, d0);
+        sum1 = vmlaq_f32(sum1, d1, d1);
+    }
+
+    sum = horizontalSum(vaddq_f32(sum0, sum1));
+#endif
+
+    for (; i < size; i++) {
+        float d = a[i] - b[i];
+
+        sum += d * d;
+    }
+
+    return sum / size;
+}
+
+float stats::meanAbsoluteError(const float* a, const float* b, int size) {
+    if (size <= 0)
+        return 0.0f;
+
+    float sum = 0.0f;
+
+    int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+    // Clearing the sign bit gives the absolute value
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+
+    for (; i + 16 <= size; i += 16) {
+        sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i))));
+        sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8))));
+    }
+
+    for (; i + 8 <= size; i += 8)
+        sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i))));
+
+    sum = horizontalSum(_mm256_add_ps(sum0, sum1));
+#elif defined(DEMOS_SIMD_NEON)
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= size; i += 8) {
+        sum0 = vaddq_f32(sum0, vabdq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+        sum1 = vaddq_f32(sum1, vabdq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4)));
+    }
+
+    sum = horizontalSum(vaddq_f32(sum0, sum1));
+#endif
+
+    for (; i < size; i++)
+        sum += std::fabs(a[i] - b[i]);
+
+    return sum / size;
+}
+
+float stats::cosineDistance(const float* a, const float* b, int size) {
+    float dot = 0.0f;
+    float squareA = 0.0f;
+    float squareB = 0.0f;
+
+    int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+    __m256 dotV = _mm256_setzero_ps();
+    __m256 squareAV = _mm256_setzero_ps();
+    __m256 squareBV = _mm256_setzero_ps();
+
+    for (; i + 8 <= size; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+
+        dotV = _mm256_fmadd_ps(va, vb, dotV);
+        squareAV = _mm256_fmadd_ps(va, va, squareAV);
+        squareBV = _mm256_fmadd_ps(vb, vb, squareBV);
+    }
+
+    dot = horizontalSum(dotV);
+    squareA = horizontalSum(squareAV);
+    squareB = horizontalSum(squareBV);
+#elif defined(DEMOS_SIMD_NEON)
+    float32x4_t dotV = vdupq_n_f32(0.0f);
+    float32x4_t squareAV = vdupq_n_f32(0.0f);
+    float32x4_t squareBV = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= size; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t vb = vld1q_f32(b + i);
+
+        dotV = vmlaq_f32(dotV, va, vb);
+        squareAV = vmlaq_f32(squareAV, va, va);
+        squareBV = vmlaq_f32(squareBV, vb, vb);
+    }
+
+    dot = horizontalSum(dotV);
+    squareA = horizontalSum(squareAV);
+    squareB = horizontalSum(squareBV);
+#endif
+
+    for (; i < size; i++) {
+        dot += a[i] * b[i];
+        squareA += a[i] * a[i];
+        squareB += b[i] * b[i];
+    }
+
+    if (squareA == 0.0f || squareB == 0.0f)
+        return squareA == squareB ? 0.0f : 1.0f;
+
+    return 1.0f - dot / std::sqrt(squareA * squareB);
+}
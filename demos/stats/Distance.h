@@ -0,0 +1,20 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+namespace stats {
+    // Distances between two vectors of size floats, vectorized with AVX2 or NEON when available
+
+    float meanSquaredError(const float* a, const float* b, int size);
+
+    float meanAbsoluteError(const float* a, const float* b, int size);
+
+    // One minus the cosine similarity. 0 when both vectors are zero, 1 when only one is
+    float cosineDistance(const float* a, const float* b, int size);
+}
@@ -0,0 +1,247 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace stats;
+
+void P2Quantile::create(double p) {
+    _p = std::min(1.0, std::max(0.0, p));
+
+    _count = 0;
+
+    for (int i = 0; i < 5; i++) {
+        _heights[i] = 0.0;
+        _positions[i] = i;
+    }
+
+    _desired[0] = 0.0;
+    _desired[1] = 2.0 * _p;
+    _desired[2] = 4.0 * _p;
+    _desired[3] = 2.0 + 2.0 * _p;
+    _desired[4] = 4.0;
+
+    _increments[0] = 0.0;
+    _increments[1] = _p * 0.5;
+    _increments[2] = _p;
+    _increments[3] = (1.0 + _p) * 0.5;
+    _increments[4] = 1.0;
+}
+
+double P2Quantile::parabolic(int i, double d) const {
+    return _heights[i] + d / (_positions[i + 1] - _positions[i - 1]) *
+        ((_positions[i] - _positions[i - 1] + d) * (_heights[i + 1] - _heights[i]) / (_positions[i + 1] - _positions[i]) +
+        (_positions[i + 1] - _positions[i] - d) * (_heights[i] - _heights[i - 1]) / (_positions[i] - _positions[i - 1]));
+}
+
+double P2Quantile::linear(int i, double d) const {
+    int j = i + static_cast<int>(d);
+
+    return _heights[i] + d * (_heights[j] - _heights[i]) / (_positions[j] - _positions[i]);
+}
+
+void P2Quantile::add(double value) {
+    // The first five values become the markers
+    if (_count < 5) {
+        _heights[_count++] = value;
+
+        if (_count == 5)
+            std::sort(_heights, _heights + 5);
+
+        return;
+    }
+
+    _count++;
+
+    // Cell of the new value, extending the extremes if needed
+    int k;
+
+    if (value < _heights[0]) {
+        _heights[0] = value;
+        k = 0;
+    }
+    else if (value >= _heights[4]) {
+        _heights[4] = value;
+        k = 3;
+    }
+    else {
+        k = 0;
+
+        while (value >= _heights[k + 1])
+            k++;
+    }
+
+    for (int i = k + 1; i < 5; i++)
+        _positions[i] += 1.0;
+
+    for (int i = 0; i < 5; i++)
+        _desired[i] += _increments[i];
+
+    // Move the middle markers towards their desired positions
+    for (int i = 1; i < 4; i++) {
+        double d = _desired[i] - _positions[i];
+
+        if ((d >= 1.0 && _positions[i + 1] - _positions[i] > 1.0) || (d <= -1.0 && _positions[i - 1] - _positions[i] < -1.0)) {
+            double step = d > 0.0 ? 1.0 : -1.0;
+
+            double height = parabolic(i, step);
+
+            if (_heights[i - 1] < height && height < _heights[i + 1])
+                _heights[i] = height;
+            else
+                _heights[i] = linear(i, step);
+
+            _positions[i] += step;
+        }
+    }
+}
+
+double P2Quantile::getQuantile() const {
+    if (_count >= 5)
+        return _heights[2];
+
+    if (_count == 0)
+        return 0.0;
+
+    double sorted[5];
+    std::copy(_heights, _heights + _count, sorted);
+    std::sort(sorted, sorted + _count);
+
+    return sorted[static_cast<int>(std::round(_p * (_count - 1)))];
+}
+
+void TDigest::create(double compression) {
+    _compression = std::max(10.0, compression);
+
+    _centroids.clear();
+    _buffer.clear();
+    _merged.clear();
+
+    _buffer.reserve(static_cast<size_t>(_compression) * 5);
+
+    _totalWeight = 0.0;
+
+    _min = std::numeric_limits<double>::infinity();
+    _max = -std::numeric_limits<double>::infinity();
+}
+
+void TDigest::add(double value, double weight) {
+    if (weight <= 0.0)
+        return;
+
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+
+    Centroid centroid;
+    centroid._mean = value;
+    centroid._weight = weight;
+
+    _buffer.push_back(centroid);
+
+    _totalWeight += weight;
+
+    if (_buffer.size() >= static_cast<size_t>(_compression) * 5)
+        merge();
+}
+
+void TDigest::merge() {
+    if (_buffer.empty())
+        return;
+
+    _buffer.insert(_buffer.end(), _centroids.begin(), _centroids.end());
+
+    std::sort(_buffer.begin(), _buffer.end(), [](const Centroid &a, const Centroid &b) {
+        return a._mean < b._mean;
+    });
+
+    // Scale function k(q) = compression / (2 pi) * asin(2q - 1), a centroid spans at most one unit of k
+    const double pi = 3.14159265358979323846;
+    const double normalizer = _compression / (2.0 * pi);
+
+    auto weightLimit = [&](double weightSoFar) {
+        double k = normalizer * std::asin(std::min(1.0, 2.0 * weightSoFar / _totalWeight - 1.0)) + 1.0;
+
+        return _totalWeight * (std::sin(std::min(pi * 0.5, k / normalizer)) + 1.0) * 0.5;
+    };
+
+    _merged.clear();
+
+    double weightSoFar = 0.0;
+    double limit = weightLimit(0.0);
+
+    Centroid current = _buffer.front();
+
+    for (size_t i = 1; i < _buffer.size(); i++) {
+        const Centroid &next = _buffer[i];
+
+        if (weightSoFar + current._weight + next._weight <= limit) {
+            current._weight += next._weight;
+            current._mean += (next._mean - current._mean) * next._weight / current._weight;
+        }
+        else {
+            weightSoFar += current._weight;
+
+            _merged.push_back(current);
+
+            limit = weightLimit(weightSoFar);
+
+            current = next;
+        }
+    }
+
+    _merged.push_back(current);
+
+    _centroids.swap(_merged);
+
+    _buffer.clear();
+}
+
+double TDigest::getQuantile(double q) {
+    merge();
+
+    if (_centroids.empty())
+        return 0.0;
+
+    if (_centroids.size() == 1)
+        return _centroids.front()._mean;
+
+    q = std::min(1.0, std::max(0.0, q));
+
+    double index = q * _totalWeight;
+
+    // Interpolate from the extremes to the outer centroid centers
+    const Centroid &first = _centroids.front();
+    const Centroid &last = _centroids.back();
+
+    if (index <= first._weight * 0.5)
+        return _min + (first._mean - _min) * index / (first._weight * 0.5);
+
+    if (index >= _totalWeight - last._weight * 0.5)
+        return _max - (_max - last._mean) * (_totalWeight - index) / (last._weight * 0.5);
+
+    // Between centroid centers
+    double weightSoFar = first._weight * 0.5;
+
+    for (size_t i = 0; i + 1 < _centroids.size(); i++) {
+        double span = (_centroids[i]._weight + _centroids[i + 1]._weight) * 0.5;
+
+        if (weightSoFar + span > index) {
+            double t = (index - weightSoFar) / span;
+
+            return _centroids[i]._mean + t * (_centroids[i + 1]._mean - _centroids[i]._mean);
+        }
+
+        weightSoFar += span;
+    }
+
+    return last._mean;
+}
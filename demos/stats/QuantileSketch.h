@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+namespace stats {
+    // Running estimate of one quantile in constant memory (the P-square algorithm of Jain and
+    // Chlamtac): five markers whose heights are adjusted parabolically as values arrive
+    class P2Quantile {
+    private:
+        double _p;
+
+        long long _count;
+
+        // Marker heights, actual and desired positions, and desired position increments
+        double _heights[5];
+        double _positions[5];
+        double _desired[5];
+        double _increments[5];
+
+        double parabolic(int i, double d) const;
+        double linear(int i, double d) const;
+
+    public:
+        P2Quantile() {
+            create(0.5);
+        }
+
+        // Track quantile p in (0, 1)
+        void create(double p);
+
+        void add(double value);
+
+        long long getCount() const {
+            return _count;
+        }
+
+        // Exact while fewer than five values have been seen
+        double getQuantile() const;
+    };
+
+    // Any quantile of a stream in bounded memory (Dunning's merging t-digest). Values are buffered
+    // and merged into weighted centroids when the buffer fills, so adds are amortized constant time.
+    // Centroids near the tails are kept small, making extreme quantiles the most accurate
+    class TDigest {
+    private:
+        struct Centroid {
+            double _mean;
+            double _weight;
+        };
+
+        double _compression;
+
+        std::vector<Centroid> _centroids;
+        std::vector<Centroid> _buffer;
+
+        // Scratch for merging
+        std::vector<Centroid> _merged;
+
+        double _totalWeight;
+
+        double _min, _max;
+
+        void merge();
+
+    public:
+        TDigest() {
+            create();
+        }
+
+        // Higher compression keeps more centroids (about compression / 2 after a merge)
+        void create(double compression = 100.0);
+
+        void add(double value, double weight = 1.0);
+
+        // Merges pending values first
+        double getQuantile(double q);
+
+        double getCount() const {
+            return _totalWeight;
+        }
+
+        int getNumCentroids() {
+            merge();
+
+            return static_cast<int>(_centroids.size());
+        }
+    };
+}
@@ -0,0 +1,133 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace stats {
+    // Mean and variance of every value seen (Welford's update, stable for long runs)
+    class Welford {
+    private:
+        long long _count;
+
+        double _mean;
+
+        // Sum of squared differences from the mean
+        double _m2;
+
+    public:
+        Welford() {
+            reset();
+        }
+
+        void reset() {
+            _count = 0;
+            _mean = 0.0;
+            _m2 = 0.0;
+        }
+
+        void add(double value) {
+            _count++;
+
+            double delta = value - _mean;
+
+            _mean += delta / _count;
+            _m2 += delta * (value - _mean);
+        }
+
+        long long getCount() const {
+            return _count;
+        }
+
+        double getMean() const {
+            return _mean;
+        }
+
+        // Population variance
+        double getVariance() const {
+            return _count > 0 ? _m2 / _count : 0.0;
+        }
+
+        double getStdDev() const {
+            return std::sqrt(getVariance());
+        }
+    };
+
+    // Exponentially weighted mean and variance. Decay is the weight kept by the old statistics on
+    // every update, the first value initializes the mean
+    class Ewma {
+    private:
+        double _decay;
+
+        bool _initialized;
+
+        double _mean;
+        double _variance;
+
+    public:
+        Ewma()
+            : _decay(0.99)
+        {
+            reset();
+        }
+
+        void create(double decay) {
+            _decay = decay;
+
+            reset();
+        }
+
+        void reset() {
+            _initialized = false;
+            _mean = 0.0;
+            _variance = 0.0;
+        }
+
+        // Restore saved statistics
+        void set(double mean, double variance) {
+            _initialized = true;
+            _mean = mean;
+            _variance = std::max(0.0, variance);
+        }
+
+        void add(double value) {
+            if (!_initialized) {
+                set(value, 0.0);
+                return;
+            }
+
+            double delta = value - _mean;
+            double increment = (1.0 - _decay) * delta;
+
+            _mean += increment;
+            _variance = _decay * (_variance + delta * increment);
+        }
+
+        double getDecay() const {
+            return _decay;
+        }
+
+        bool isInitialized() const {
+            return _initialized;
+        }
+
+        double getMean() const {
+            return _mean;
+        }
+
+        double getVariance() const {
+            return _variance;
+        }
+
+        double getStdDev() const {
+            return std::sqrt(_variance);
+        }
+    };
+}
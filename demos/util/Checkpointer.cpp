@@ -0,0 +1,325 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "Checkpointer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <utility>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WINDOWS)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace util;
+
+namespace {
+    // Force a file's contents to stable storage
+    bool syncFile(const std::string &fileName) {
+#if defined(_WINDOWS)
+        HANDLE handle = CreateFileA(fileName.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (handle == INVALID_HANDLE_VALUE)
+            return false;
+
+        bool synced = FlushFileBuffers(handle) != 0;
+
+        CloseHandle(handle);
+
+        return synced;
+#else
+        int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+
+        if (fileDescriptor < 0)
+            return false;
+
+        bool synced = fsync(fileDescriptor) == 0;
+
+        ::close(fileDescriptor);
+
+        return synced;
+#endif
+    }
+
+    // Persist a rename by syncing the containing directory (not needed on Windows)
+    void syncDirectory(const std::string &fileName) {
+#if !defined(_WINDOWS)
+        size_t slash = fileName.find_last_of('/');
+
+        std::string directory = slash == std::string::npos ? "." : fileName.substr(0, slash + 1);
+
+        int fileDescriptor = open(directory.c_str(), O_RDONLY);
+
+        if (fileDescriptor >= 0) {
+            fsync(fileDescriptor);
+
+            ::close(fileDescriptor);
+        }
+#endif
+    }
+
+    bool listDirectory(const std::string &directory, std::vector<std::string> &fileNames) {
+#if defined(_WINDOWS)
+        WIN32_FIND_DATAA findData;
+
+        HANDLE findHandle = FindFirstFileA((directory + "/*").c_str(), &findData);
+
+        if (findHandle == INVALID_HANDLE_VALUE)
+            return false;
+
+        do {
+            if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                fileNames.push_back(findData.cFileName);
+        } while (FindNextFileA(findHandle, &findData));
+
+        FindClose(findHandle);
+#else
+        DIR* dir = opendir(directory.c_str());
+
+        if (dir == nullptr)
+            return false;
+
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.')
+                fileNames.push_back(entry->d_name);
+        }
+
+        closedir(dir);
+#endif
+
+        return true;
+    }
+
+    // Whether fileName is <baseName>.<frames>.ohr
+    bool isCheckpointName(const std::string &fileName, const std::string &baseName) {
+        const std::string extension = ".ohr";
+
+        if (fileName.size() <= baseName.size() + 1 + extension.size())
+            return false;
+
+        if (fileName.compare(0, baseName.size(), baseName) != 0 || fileName[baseName.size()] != '.')
+            return false;
+
+        if (fileName.compare(fileName.size() - extension.size(), extension.size(), extension) != 0)
+            return false;
+
+        for (size_t i = baseName.size() + 1; i < fileName.size() - extension.size(); i++)
+            if (!std::isdigit(static_cast<unsigned char>(fileName[i])))
+                return false;
+
+        return true;
+    }
+
+    // Checkpoints already on disk for a prefix, oldest first by modification time
+    std::vector<std::string> findCheckpoints(const std::string &prefix) {
+        size_t slash = prefix.find_last_of("/\\");
+
+        std::string directory = slash == std::string::npos ? "." : (slash == 0 ? prefix.substr(0, 1) : prefix.substr(0, slash));
+        std::string baseName = slash == std::string::npos ? prefix : prefix.substr(slash + 1);
+
+        std::vector<std::string> fileNames;
+
+        std::vector<std::pair<time_t, std::string>> found;
+
+        if (!baseName.empty() && listDirectory(directory, fileNames)) {
+            for (const std::string &fileName : fileNames) {
+                if (!isCheckpointName(fileName, baseName))
+                    continue;
+
+                std::string path = slash == std::string::npos ? fileName : directory + "/" + fileName;
+
+                struct stat fileStat;
+
+                if (stat(path.c_str(), &fileStat) == 0)
+                    found.push_back(std::make_pair(fileStat.st_mtime, path));
+            }
+        }
+
+        std::sort(found.begin(), found.end());
+
+        std::vector<std::string> checkpoints;
+
+        for (const std::pair<time_t, std::string> &f : found)
+            checkpoints.push_back(f.second);
+
+        return checkpoints;
+    }
+}
+
+void Checkpointer::create(const std::string &prefix, int64_t everyFrames, float everyMinutes, int retain) {
+    finish();
+
+    _prefix = prefix;
+    _everyFrames = everyFrames;
+    _everyMinutes = everyMinutes;
+    _retain = std::max(1, retain);
+
+    _lastFrames = 0;
+    _lastTime = std::chrono::steady_clock::now();
+
+    // Checkpoints left by earlier runs count towards the retention limit
+    _kept = findCheckpoints(prefix);
+
+    _stop = false;
+
+    _thread = std::thread(&Checkpointer::flush, this);
+}
+
+bool Checkpointer::isDue(int64_t framesTrained) const {
+    if (!_thread.joinable())
+        return false;
+
+    if (_everyFrames > 0 && framesTrained - _lastFrames >= _everyFrames)
+        return true;
+
+    if (_everyMinutes > 0.0f) {
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - _lastTime;
+
+        if (elapsed.count() >= _everyMinutes * 60.0f)
+            return true;
+    }
+
+    return false;
+}
+
+float Checkpointer::save(ogmaneo::Hierarchy &hierarchy, ogmaneo::ComputeSystem &cs, int64_t framesTrained) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    Pending pending;
+    pending._fileName = _prefix + "." + std::to_string(framesTrained) + ".ohr";
+    pending._tempFileName = pending._fileName + ".tmp";
+
+    // Device read back and the full serialization happen here, training cannot continue until this returns
+    hierarchy.save(cs, pending._tempFileName);
+
+    std::chrono::duration<float> stall = std::chrono::steady_clock::now() - start;
+
+    _lastFrames = framesTrained;
+    _lastTime = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _pending.push_back(pending);
+
+        _numSaved++;
+        _totalStallSeconds += stall.count();
+        _maxStallSeconds = std::max(_maxStallSeconds, stall.count());
+    }
+
+    _condition.notify_all();
+
+    return stall.count();
+}
+
+void Checkpointer::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (;;) {
+        _condition.wait(lock, [this]() { return _stop || !_pending.empty(); });
+
+        if (_pending.empty())
+            break;
+
+        Pending pending = _pending.front();
+        _pending.pop_front();
+
+        lock.unlock();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        bool succeeded = syncFile(pending._tempFileName) && std::rename(pending._tempFileName.c_str(), pending._fileName.c_str()) == 0;
+
+        if (succeeded) {
+            syncDirectory(pending._fileName);
+
+            // A checkpoint of an earlier run with the same frame count was just replaced
+            _kept.erase(std::remove(_kept.begin(), _kept.end(), pending._fileName), _kept.end());
+
+            _kept.push_back(pending._fileName);
+
+            // Retention, oldest first
+            while (static_cast<int>(_kept.size()) > _retain) {
+                std::remove(_kept.front().c_str());
+
+                _kept.erase(_kept.begin());
+            }
+        }
+        else {
+            std::cerr << "Could not write checkpoint: " << pending._fileName << std::endl;
+
+            std::remove(pending._tempFileName.c_str());
+        }
+
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+
+        if (succeeded)
+            _numCheckpoints++;
+        else
+            _numFailed++;
+
+        _lastFlushSeconds = elapsed.count();
+    }
+}
+
+void Checkpointer::finish() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // The flush thread drains the queue before it exits
+        _stop = true;
+    }
+
+    _condition.notify_all();
+
+    if (_thread.joinable())
+        _thread.join();
+}
+
+int Checkpointer::getNumCheckpoints() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _numCheckpoints;
+}
+
+int Checkpointer::getNumFailed() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _numFailed;
+}
+
+float Checkpointer::getMeanStallSeconds() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _numSaved > 0 ? _totalStallSeconds / _numSaved : 0.0f;
+}
+
+float Checkpointer::getMaxStallSeconds() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _maxStallSeconds;
+}
+
+float Checkpointer::getLastFlushSeconds() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _lastFlushSeconds;
+}
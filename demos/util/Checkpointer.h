@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <neo/Hierarchy.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace util {
+    // Periodic hierarchy checkpoints during training. Checkpoints are crash safe, not non-blocking:
+    // Hierarchy::save only writes to a file, so the whole device read back and serialization to a
+    // temporary file runs on the calling thread and stalls training for its duration. A background
+    // thread then syncs it to disk, renames it to <prefix>.<frames>.ohr and deletes the oldest
+    // checkpoints beyond the retention limit, including those found on disk from earlier runs.
+    // A crash leaves either a complete checkpoint or a stray .tmp file
+    class Checkpointer {
+    private:
+        // A serialized checkpoint waiting to be made durable
+        struct Pending {
+            std::string _tempFileName;
+            std::string _fileName;
+        };
+
+        std::string _prefix;
+
+        int64_t _everyFrames;
+        float _everyMinutes;
+        int _retain;
+
+        int64_t _lastFrames;
+        std::chrono::steady_clock::time_point _lastTime;
+
+        std::thread _thread;
+        mutable std::mutex _mutex;
+        std::condition_variable _condition;
+
+        std::deque<Pending> _pending;
+        bool _stop;
+
+        // Completed checkpoints with this prefix, oldest first (background thread only)
+        std::vector<std::string> _kept;
+
+        // Statistics, guarded by _mutex
+        int _numSaved;
+        int _numCheckpoints;
+        int _numFailed;
+        float _totalStallSeconds;
+        float _maxStallSeconds;
+        float _lastFlushSeconds;
+
+        void flush();
+
+    public:
+        Checkpointer()
+            : _everyFrames(0), _everyMinutes(0.0f), _retain(1), _lastFrames(0),
+            _stop(false), _numSaved(0), _numCheckpoints(0), _numFailed(0),
+            _totalStallSeconds(0.0f), _maxStallSeconds(0.0f), _lastFlushSeconds(0.0f)
+        {}
+
+        ~Checkpointer() {
+            finish();
+        }
+
+        // Checkpoint every everyFrames trained frames or everyMinutes minutes, whichever comes first
+        // (0 disables either), keeping the newest retain checkpoints with this prefix, earlier runs included
+        void create(const std::string &prefix, int64_t everyFrames, float everyMinutes, int retain);
+
+        // Whether a checkpoint is due after framesTrained frames
+        bool isDue(int64_t framesTrained) const;
+
+        // Serialize the hierarchy (blocking) and queue it for flushing. Returns the training stall in seconds
+        float save(ogmaneo::Hierarchy &hierarchy, ogmaneo::ComputeSystem &cs, int64_t framesTrained);
+
+        // Wait for queued checkpoints to be flushed and stop the background thread
+        void finish();
+
+        int getNumCheckpoints() const;
+
+        int getNumFailed() const;
+
+        float getMeanStallSeconds() const;
+
+        float getMaxStallSeconds() const;
+
+        // Background flush time of the most recent checkpoint
+        float getLastFlushSeconds() const;
+    };
+}
@@ -0,0 +1,43 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "InputStaging.h"
+
+#include <algorithm>
+
+using namespace util;
+
+void InputStaging::create(const std::shared_ptr<ogmaneo::Hierarchy> &hierarchy, const std::vector<ogmaneo::Vec2i> &inputSizes, float defaultValue) {
+    _hierarchy = hierarchy;
+
+    _inputs.clear();
+    _initialPredictions.clear();
+
+    for (const ogmaneo::Vec2i &size : inputSizes) {
+        _inputs.push_back(ogmaneo::ValueField2D(size, defaultValue));
+        _initialPredictions.push_back(ogmaneo::ValueField2D(size, 0.0f));
+    }
+}
+
+const ogmaneo::ValueField2D &InputStaging::getPrediction(int index) const {
+    const std::vector<ogmaneo::ValueField2D> &predictions = _hierarchy->getPredictions();
+
+    if (index < static_cast<int>(predictions.size()) &&
+        predictions[index].getData().size() == _initialPredictions[index].getData().size())
+        return predictions[index];
+
+    return _initialPredictions[index];
+}
+
+void InputStaging::feedBackPredictions() {
+    for (int i = 0; i < getNumInputs(); i++) {
+        const std::vector<float> &prediction = getPrediction(i).getData();
+
+        std::copy(prediction.begin(), prediction.end(), _inputs[i].getData().begin());
+    }
+}
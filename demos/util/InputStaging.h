@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <neo/Hierarchy.h>
+
+#include <memory>
+#include <vector>
+
+namespace util {
+    // Persistent input fields for a hierarchy. Inputs are written in place and passed to the
+    // hierarchy without building a new input vector, and predictions are read through views
+    // of the hierarchy's own fields, so a simulation step performs no heap allocations
+    class InputStaging {
+    private:
+        std::shared_ptr<ogmaneo::Hierarchy> _hierarchy;
+
+        std::vector<ogmaneo::ValueField2D> _inputs;
+
+        // Returned as predictions until the hierarchy has produced its own
+        std::vector<ogmaneo::ValueField2D> _initialPredictions;
+
+    public:
+        // One input field per input layer, in the order the layers were added to the Architect
+        void create(const std::shared_ptr<ogmaneo::Hierarchy> &hierarchy, const std::vector<ogmaneo::Vec2i> &inputSizes, float defaultValue = 0.0f);
+
+        ogmaneo::ValueField2D &getInput(int index) {
+            return _inputs[index];
+        }
+
+        float* getInputData(int index) {
+            return _inputs[index].getData().data();
+        }
+
+        // All inputs, for hierarchy calls that take extra arguments
+        std::vector<ogmaneo::ValueField2D> &getInputs() {
+            return _inputs;
+        }
+
+        int getNumInputs() const {
+            return static_cast<int>(_inputs.size());
+        }
+
+        void activate() {
+            _hierarchy->activate(_inputs);
+        }
+
+        void learn() {
+            _hierarchy->learn(_inputs);
+        }
+
+        // Read-only view of a prediction, valid until the next activate
+        const ogmaneo::ValueField2D &getPrediction(int index) const;
+
+        const float* getPredictionData(int index) const {
+            return getPrediction(index).getData().data();
+        }
+
+        // Copy the predictions into the inputs, for running the hierarchy on its own output
+        void feedBackPredictions();
+    };
+}
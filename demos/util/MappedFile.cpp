@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "MappedFile.h"
+
+#if defined(_WINDOWS)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace util;
+
+MappedFile::MappedFile()
+    : _data(nullptr), _size(0),
+#if defined(_WINDOWS)
+    _fileHandle(INVALID_HANDLE_VALUE), _mappingHandle(nullptr)
+#else
+    _fileDescriptor(-1)
+#endif
+{}
+
+bool MappedFile::open(const std::string &fileName, bool sequentialAccess) {
+    close();
+
+#if defined(_WINDOWS)
+    _fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        sequentialAccess ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (_fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(_fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    _mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (_mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+
+    _data = static_cast<const unsigned char*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    _size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    _fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+
+    if (_fileDescriptor < 0)
+        return false;
+
+    struct stat fileStat;
+
+    if (fstat(_fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+        close();
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, _fileDescriptor, 0);
+
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    if (sequentialAccess)
+        madvise(mapping, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+
+    _data = static_cast<const unsigned char*>(mapping);
+    _size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    if (_data == nullptr) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close() {
+#if defined(_WINDOWS)
+    if (_data != nullptr)
+        UnmapViewOfFile(_data);
+
+    if (_mappingHandle != nullptr)
+        CloseHandle(_mappingHandle);
+
+    if (_fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(_fileHandle);
+
+    _fileHandle = INVALID_HANDLE_VALUE;
+    _mappingHandle = nullptr;
+#else
+    if (_data != nullptr)
+        munmap(const_cast<unsigned char*>(_data), _size);
+
+    if (_fileDescriptor >= 0)
+        ::close(_fileDescriptor);
+
+    _fileDescriptor = -1;
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
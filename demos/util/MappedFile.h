@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace util {
+    // Read-only memory mapping of a whole file
+    class MappedFile {
+    private:
+        const unsigned char* _data;
+        size_t _size;
+
+#if defined(_WINDOWS)
+        void* _fileHandle;
+        void* _mappingHandle;
+#else
+        int _fileDescriptor;
+#endif
+
+    public:
+        MappedFile();
+
+        ~MappedFile() {
+            close();
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // Map a file, sequentialAccess hints the OS to read ahead aggressively
+        bool open(const std::string &fileName, bool sequentialAccess = false);
+
+        void close();
+
+        bool isOpen() const {
+            return _data != nullptr;
+        }
+
+        const unsigned char* getData() const {
+            return _data;
+        }
+
+        size_t getSize() const {
+            return _size;
+        }
+    };
+}
@@ -0,0 +1,168 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "MetricsLog.h"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#if defined(_WINDOWS)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace util;
+
+namespace {
+    const char metricsMagic[4] = { 'O', 'N', 'M', 'L' };
+
+    bool isValidHeader(const MetricsHeader &header) {
+        return std::memcmp(header._magic, metricsMagic, sizeof(metricsMagic)) == 0 &&
+            header._version == MetricsLog::_version && header._recordSize == sizeof(MetricsRecord);
+    }
+
+    bool truncateFile(std::FILE* file, long size) {
+        std::fflush(file);
+
+#if defined(_WINDOWS)
+        return _chsize_s(_fileno(file), size) == 0;
+#else
+        return ftruncate(fileno(file), size) == 0;
+#endif
+    }
+}
+
+bool MetricsLog::create(const std::string &fileName, int capacity) {
+    close();
+
+    _file = std::fopen(fileName.c_str(), "ab+");
+
+    if (_file == nullptr)
+        return false;
+
+    // Reads are positioned explicitly, writes in append mode always go to the end
+    std::fseek(_file, 0, SEEK_END);
+
+    long size = std::ftell(_file);
+
+    if (size == 0) {
+        MetricsHeader header;
+        std::memcpy(header._magic, metricsMagic, sizeof(metricsMagic));
+        header._version = _version;
+        header._recordSize = sizeof(MetricsRecord);
+        header._reserved = 0;
+
+        std::fwrite(&header, sizeof(MetricsHeader), 1, _file);
+    }
+    else {
+        MetricsHeader header;
+
+        std::fseek(_file, 0, SEEK_SET);
+
+        if (std::fread(&header, sizeof(MetricsHeader), 1, _file) != 1 || !isValidHeader(header)) {
+            // Not a log of this format
+            std::fclose(_file);
+            _file = nullptr;
+
+            return false;
+        }
+
+        // A run killed mid write leaves a torn last record, drop it and append after the last whole one
+        long numRecords = (size - static_cast<long>(sizeof(MetricsHeader))) / static_cast<long>(sizeof(MetricsRecord));
+        long recordsEnd = static_cast<long>(sizeof(MetricsHeader)) + numRecords * static_cast<long>(sizeof(MetricsRecord));
+
+        if (recordsEnd != size && !truncateFile(_file, recordsEnd)) {
+            std::fclose(_file);
+            _file = nullptr;
+
+            return false;
+        }
+    }
+
+    _queue.create(capacity);
+
+    _stop = false;
+    _written = 0;
+    _dropped = 0;
+
+    _thread = std::thread(&MetricsLog::drain, this);
+
+    return true;
+}
+
+void MetricsLog::drain() {
+    const size_t batchSize = 1024;
+
+    std::vector<MetricsRecord> batch;
+    batch.reserve(batchSize);
+
+    for (;;) {
+        // Stop is read before the last look at the queue so no record pushed before close is lost
+        bool stop = _stop;
+
+        MetricsRecord* record;
+
+        while (batch.size() < batchSize && (record = _queue.front()) != nullptr) {
+            batch.push_back(*record);
+
+            _queue.pop();
+        }
+
+        if (!batch.empty()) {
+            std::fwrite(batch.data(), sizeof(MetricsRecord), batch.size(), _file);
+
+            _written += batch.size();
+
+            // Only idle once the queue is empty
+            if (batch.size() == batchSize) {
+                batch.clear();
+                continue;
+            }
+
+            batch.clear();
+
+            std::fflush(_file);
+        }
+
+        if (stop)
+            break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+void MetricsLog::close() {
+    if (_file == nullptr)
+        return;
+
+    _stop = true;
+
+    if (_thread.joinable())
+        _thread.join();
+
+    std::fclose(_file);
+    _file = nullptr;
+}
+
+bool MetricsReader::open(const std::string &fileName) {
+    _numRecords = 0;
+
+    if (!_file.open(fileName, true))
+        return false;
+
+    if (_file.getSize() < sizeof(MetricsHeader) || !isValidHeader(*reinterpret_cast<const MetricsHeader*>(_file.getData()))) {
+        _file.close();
+        return false;
+    }
+
+    _numRecords = (_file.getSize() - sizeof(MetricsHeader)) / sizeof(MetricsRecord);
+
+    return true;
+}
@@ -0,0 +1,135 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include "MappedFile.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+namespace util {
+    // One training step, stored as is in the log file
+    struct MetricsRecord {
+        // Frames trained over all passes
+        uint64_t _step;
+
+        int32_t _pass;
+
+        // Frame index in the source
+        int32_t _frame;
+
+        float _mse;
+
+        // Hierarchy activate + learn time
+        float _stepSeconds;
+
+        // Time spent reading the frame (on the decode thread)
+        float _decodeSeconds;
+
+        uint32_t _reserved;
+    };
+
+    static_assert(sizeof(MetricsRecord) == 32, "MetricsRecord layout is part of the file format");
+
+    struct MetricsHeader {
+        char _magic[4];
+        uint32_t _version;
+        uint32_t _recordSize;
+        uint32_t _reserved;
+    };
+
+    // Append-only binary metrics log. The training thread pushes records into a lock-free ring
+    // (never blocking, records are dropped and counted if the ring is full) and a background
+    // thread writes them out in batches
+    class MetricsLog {
+    private:
+        SpscQueue<MetricsRecord> _queue;
+
+        std::FILE* _file;
+
+        std::thread _thread;
+
+        std::atomic<bool> _stop;
+
+        std::atomic<uint64_t> _written;
+        std::atomic<uint64_t> _dropped;
+
+        void drain();
+
+    public:
+        static const uint32_t _version = 1;
+
+        MetricsLog()
+            : _file(nullptr), _stop(false), _written(0), _dropped(0)
+        {}
+
+        ~MetricsLog() {
+            close();
+        }
+
+        // Open (appending to a log of the same format if it exists, dropping a torn last record) and start the writer thread
+        bool create(const std::string &fileName, int capacity = 1 << 16);
+
+        // Write out queued records and close the file
+        void close();
+
+        bool isOpen() const {
+            return _file != nullptr;
+        }
+
+        // Queue a record, training thread only
+        void log(const MetricsRecord &record) {
+            MetricsRecord* slot = _queue.beginPush();
+
+            if (slot == nullptr) {
+                _dropped++;
+                return;
+            }
+
+            *slot = record;
+
+            _queue.endPush();
+        }
+
+        uint64_t getWritten() const {
+            return _written;
+        }
+
+        uint64_t getDropped() const {
+            return _dropped;
+        }
+    };
+
+    // Memory mapped view of a metrics log. A partially written last record is ignored
+    class MetricsReader {
+    private:
+        MappedFile _file;
+
+        size_t _numRecords;
+
+    public:
+        MetricsReader()
+            : _numRecords(0)
+        {}
+
+        bool open(const std::string &fileName);
+
+        size_t getNumRecords() const {
+            return _numRecords;
+        }
+
+        const MetricsRecord &getRecord(size_t index) const {
+            return reinterpret_cast<const MetricsRecord*>(_file.getData() + sizeof(MetricsHeader))[index];
+        }
+    };
+}
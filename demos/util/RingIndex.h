@@ -0,0 +1,62 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+namespace util {
+    // Index arithmetic of a fixed capacity ring, newest first. Storage lives elsewhere (e.g. one
+    // array per field), indexed by the physical slot returned here. Once full, pushing recycles
+    // the slot of the oldest entry instead of shifting anything
+    class RingIndex {
+    private:
+        int _capacity;
+
+        // Slot of the newest entry
+        int _head;
+
+        int _size;
+
+    public:
+        RingIndex()
+            : _capacity(0), _head(0), _size(0)
+        {}
+
+        void create(int capacity) {
+            _capacity = capacity;
+            _head = 0;
+            _size = 0;
+        }
+
+        // Make room for a new newest entry, returns its slot (the oldest entry's slot when full)
+        int pushFront() {
+            _head = (_head + _capacity - 1) % _capacity;
+
+            if (_size < _capacity)
+                _size++;
+
+            return _head;
+        }
+
+        // Slot of the i'th newest entry
+        int getSlot(int i) const {
+            return (_head + i) % _capacity;
+        }
+
+        int size() const {
+            return _size;
+        }
+
+        int getCapacity() const {
+            return _capacity;
+        }
+
+        bool isFull() const {
+            return _size == _capacity;
+        }
+    };
+}
@@ -0,0 +1,33 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+// Instruction set selection for the CPU kernels. AVX2 is opt-in (USE_AVX2 in CMake),
+// NEON is always available on AArch64. Kernels fall back to scalar code otherwise.
+// MSVC never defines __FMA__, but /arch:AVX2 enables FMA along with AVX2
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define DEMOS_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DEMOS_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace util {
+    inline const char* getSimdName() {
+#if defined(DEMOS_SIMD_AVX2)
+        return "AVX2";
+#elif defined(DEMOS_SIMD_NEON)
+        return "NEON";
+#else
+        return "scalar";
+#endif
+    }
+}
@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstddef>
+
+namespace util {
+    // Wait step for polling either end of a queue. Spins briefly before sleeping,
+    // waits are usually shorter than a frame
+    inline void backOff(int &spins) {
+        if (spins++ < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // Bounded lock-free single producer / single consumer ring.
+    // Slots are preallocated and filled in place, so pushing and popping never allocates
+    template<class T>
+    class SpscQueue {
+    private:
+        std::vector<T> _slots;
+
+        // Separate cache lines so producer and consumer do not false share
+        alignas(64) std::atomic<size_t> _head; // Next slot to pop (consumer owned)
+        alignas(64) std::atomic<size_t> _tail; // Next slot to push (producer owned)
+
+    public:
+        SpscQueue()
+            : _head(0), _tail(0)
+        {}
+
+        // Not thread safe, call before the producer and consumer start
+        void create(size_t capacity, const T &prototype = T()) {
+            _slots.assign(capacity + 1, prototype);
+
+            _head.store(0);
+            _tail.store(0);
+        }
+
+        // Producer: slot to fill, or nullptr if the queue is full
+        T* beginPush() {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            size_t next = (tail + 1) % _slots.size();
+
+            if (next == _head.load(std::memory_order_acquire))
+                return nullptr;
+
+            return &_slots[tail];
+        }
+
+        // Producer: publish the slot returned by beginPush
+        void endPush() {
+            _tail.store((_tail.load(std::memory_order_relaxed) + 1) % _slots.size(), std::memory_order_release);
+        }
+
+        // Consumer: oldest element, or nullptr if the queue is empty
+        T* front() {
+            size_t head = _head.load(std::memory_order_relaxed);
+
+            if (head == _tail.load(std::memory_order_acquire))
+                return nullptr;
+
+            return &_slots[head];
+        }
+
+        // Consumer: release the element returned by front
+        void pop() {
+            _head.store((_head.load(std::memory_order_relaxed) + 1) % _slots.size(), std::memory_order_release);
+        }
+
+        // Approximate number of queued elements (exact when called from either end)
+        size_t size() const {
+            size_t head = _head.load(std::memory_order_acquire);
+            size_t tail = _tail.load(std::memory_order_acquire);
+
+            return (tail + _slots.size() - head) % _slots.size();
+        }
+
+        size_t getCapacity() const {
+            return _slots.size() - 1;
+        }
+    };
+}
@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace util;
+
+void ThreadPool::create(int numThreads) {
+    destroy();
+
+    _stop = false;
+
+    for (int i = 0; i < std::max(1, numThreads); i++)
+        _threads.push_back(std::thread(&ThreadPool::work, this));
+}
+
+void ThreadPool::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _stop = true;
+    }
+
+    _taskCondition.notify_all();
+
+    for (std::thread &thread : _threads)
+        thread.join();
+
+    _threads.clear();
+}
+
+void ThreadPool::work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    for (;;) {
+        _taskCondition.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+
+        // Queued tasks still run when stopping
+        if (_tasks.empty())
+            break;
+
+        std::function<void()> task = std::move(_tasks.front());
+        _tasks.pop_front();
+
+        lock.unlock();
+
+        task();
+
+        lock.lock();
+
+        if (--_outstanding == 0)
+            _idleCondition.notify_all();
+    }
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _tasks.push_back(std::move(task));
+
+        _outstanding++;
+    }
+
+    _taskCondition.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    _idleCondition.wait(lock, [this]() { return _outstanding == 0; });
+}
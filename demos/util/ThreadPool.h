@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+    // Fixed set of worker threads running queued tasks in order of submission
+    class ThreadPool {
+    private:
+        std::vector<std::thread> _threads;
+
+        std::mutex _mutex;
+        std::condition_variable _taskCondition;
+        std::condition_variable _idleCondition;
+
+        std::deque<std::function<void()>> _tasks;
+
+        // Tasks queued or running
+        int _outstanding;
+
+        bool _stop;
+
+        void work();
+
+    public:
+        ThreadPool()
+            : _outstanding(0), _stop(false)
+        {}
+
+        ~ThreadPool() {
+            destroy();
+        }
+
+        // Start numThreads workers (at least one)
+        void create(int numThreads);
+
+        // Finish outstanding tasks and join the workers
+        void destroy();
+
+        void push(std::function<void()> task);
+
+        // Block until every pushed task has completed
+        void wait();
+
+        int getNumThreads() const {
+            return static_cast<int>(_threads.size());
+        }
+    };
+}
@@ -0,0 +1,304 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "ClipDataset.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WINDOWS)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+using namespace video;
+
+namespace {
+    bool hasVideoExtension(const std::string &fileName) {
+        static const char* extensions[] = { ".mp4", ".m4v", ".avi", ".mkv", ".mov", ".wmv", ".webm", ".mpg", ".mpeg" };
+
+        size_t dot = fileName.find_last_of('.');
+
+        if (dot == std::string::npos)
+            return false;
+
+        std::string extension = fileName.substr(dot);
+
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        for (const char* e : extensions)
+            if (extension == e)
+                return true;
+
+        return false;
+    }
+
+    bool isDirectory(const struct stat &pathStat) {
+#if defined(_WINDOWS)
+        return (pathStat.st_mode & _S_IFMT) == _S_IFDIR;
+#else
+        return S_ISDIR(pathStat.st_mode);
+#endif
+    }
+
+    bool isRegularFile(const struct stat &pathStat) {
+#if defined(_WINDOWS)
+        return (pathStat.st_mode & _S_IFMT) == _S_IFREG;
+#else
+        return S_ISREG(pathStat.st_mode);
+#endif
+    }
+
+    bool isAbsolutePath(const std::string &path) {
+        return (!path.empty() && (path[0] == '/' || path[0] == '\\')) || (path.size() > 1 && path[1] == ':');
+    }
+
+    bool listDirectory(const std::string &directory, std::vector<std::string> &fileNames) {
+#if defined(_WINDOWS)
+        WIN32_FIND_DATAA findData;
+
+        HANDLE findHandle = FindFirstFileA((directory + "/*").c_str(), &findData);
+
+        if (findHandle == INVALID_HANDLE_VALUE)
+            return false;
+
+        do {
+            if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                fileNames.push_back(findData.cFileName);
+        } while (FindNextFileA(findHandle, &findData));
+
+        FindClose(findHandle);
+#else
+        DIR* dir = opendir(directory.c_str());
+
+        if (dir == nullptr)
+            return false;
+
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.')
+                fileNames.push_back(entry->d_name);
+        }
+
+        closedir(dir);
+#endif
+
+        return true;
+    }
+}
+
+bool video::listClips(const std::string &path, std::vector<std::string> &clips) {
+    clips.clear();
+
+    struct stat pathStat;
+
+    if (stat(path.c_str(), &pathStat) != 0)
+        return false;
+
+    if (isDirectory(pathStat)) {
+        std::vector<std::string> fileNames;
+
+        if (!listDirectory(path, fileNames))
+            return false;
+
+        // Sorted so that a seed gives the same order on every platform
+        std::sort(fileNames.begin(), fileNames.end());
+
+        for (const std::string &fileName : fileNames)
+            if (hasVideoExtension(fileName))
+                clips.push_back(path + "/" + fileName);
+    }
+    else if (!isRegularFile(pathStat)) {
+        std::cerr << "Not a clip directory or manifest file: " << path << std::endl;
+        return false;
+    }
+    else {
+        std::ifstream manifest(path);
+
+        if (!manifest.is_open())
+            return false;
+
+        size_t slash = path.find_last_of("/\\");
+
+        std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+        std::string line;
+
+        while (std::getline(manifest, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+
+            if (first == std::string::npos || line[first] == '#')
+                continue;
+
+            size_t last = line.find_last_not_of(" \t\r");
+
+            std::string clip = line.substr(first, last - first + 1);
+
+            clips.push_back(isAbsolutePath(clip) ? clip : directory + clip);
+        }
+    }
+
+    return !clips.empty();
+}
+
+void ClipDataset::create(const std::vector<std::string> &clips, int width, int height, int frameSkip,
+    int prefetchCount, unsigned long seed)
+{
+    stopPass();
+
+    _clips = clips;
+    _width = width;
+    _height = height;
+    _frameSkip = frameSkip;
+    _prefetchCount = std::max(1, prefetchCount);
+
+    _generator.seed(seed);
+
+    _order.resize(_clips.size());
+
+    for (int i = 0; i < static_cast<int>(_order.size()); i++)
+        _order[i] = i;
+
+    startPass();
+}
+
+void ClipDataset::startPass() {
+    std::shuffle(_order.begin(), _order.end(), _generator);
+
+    _ready.clear();
+    _current.reset();
+
+    _stop = false;
+    _prefetchDone = false;
+    _passFresh = true;
+
+    _clipsStarted = 0;
+    _clipsFailed = 0;
+    _prefetchStalls = 0;
+
+    _thread = std::thread(&ClipDataset::prefetch, this);
+}
+
+void ClipDataset::stopPass() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _stop = true;
+    }
+
+    _spaceCondition.notify_all();
+
+    if (_thread.joinable())
+        _thread.join();
+
+    _ready.clear();
+    _current.reset();
+}
+
+void ClipDataset::prefetch() {
+    for (int clipIndex : _order) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _spaceCondition.wait(lock, [this]() { return _stop || static_cast<int>(_ready.size()) < _prefetchCount; });
+
+            if (_stop)
+                return;
+        }
+
+        const std::string &fileName = _clips[clipIndex];
+
+        std::unique_ptr<PreparedClip> clip(new PreparedClip());
+
+        int clipWidth = 0;
+        int clipHeight = 0;
+
+        if (clip->_capture.open(fileName)) {
+            clipWidth = static_cast<int>(clip->_capture.get(cv::CAP_PROP_FRAME_WIDTH));
+            clipHeight = static_cast<int>(clip->_capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+        }
+
+        if (clipWidth <= 0 || clipHeight <= 0) {
+            std::cerr << "Could not open clip: " << fileName << std::endl;
+
+            _clipsFailed++;
+
+            continue;
+        }
+
+        // Resampler tables for this clip's resolution
+        clip->_resampler.create(clipWidth, clipHeight, _width, _height);
+
+        clip->_source.reset(new CaptureFrameSource(clip->_capture, clip->_resampler, _frameSkip));
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _ready.push_back(std::move(clip));
+        }
+
+        _readyCondition.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _prefetchDone = true;
+    }
+
+    _readyCondition.notify_all();
+}
+
+bool ClipDataset::read(unsigned char* planes, int &sourceFrame) {
+    _passFresh = false;
+
+    for (;;) {
+        if (_current != nullptr) {
+            if (_current->_source->read(planes, sourceFrame))
+                return true;
+
+            _current.reset();
+        }
+
+        // Move on to the next opened clip
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (_ready.empty() && !_prefetchDone) {
+                _prefetchStalls++;
+
+                _readyCondition.wait(lock, [this]() { return !_ready.empty() || _prefetchDone; });
+            }
+
+            if (_ready.empty())
+                return false;
+
+            _current = std::move(_ready.front());
+            _ready.pop_front();
+        }
+
+        _spaceCondition.notify_one();
+
+        _clipsStarted++;
+    }
+}
+
+void ClipDataset::rewind() {
+    // Keep the clips already opened if the pass has not been read from
+    if (_passFresh)
+        return;
+
+    stopPass();
+    startPass();
+}
@@ -0,0 +1,124 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui.hpp>
+
+#include "FrameSource.h"
+#include "Resampler.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace video {
+    // Gather clip file names from a directory (files with a video extension, sorted by name)
+    // or from a manifest text file (one path per line, relative to the manifest, # comments)
+    bool listClips(const std::string &path, std::vector<std::string> &clips);
+
+    // Frames streamed from many clips, in a new shuffled order each pass.
+    // A background thread opens the upcoming clips (container probing, resampler tables for the
+    // clip's resolution) while the current clip is decoded, so clips follow each other without a stall.
+    // Clips of any resolution or aspect ratio are fitted and letterboxed to the output size
+    class ClipDataset : public FrameSource {
+    private:
+        // A clip opened ahead of time, decoded by its own capture source
+        struct PreparedClip {
+            cv::VideoCapture _capture;
+            Resampler _resampler;
+
+            std::unique_ptr<CaptureFrameSource> _source;
+        };
+
+        std::vector<std::string> _clips;
+
+        // Clip indices in the order of the current pass
+        std::vector<int> _order;
+
+        int _width, _height;
+        int _frameSkip;
+        int _prefetchCount;
+
+        std::mt19937 _generator;
+
+        // Prefetch thread state, guarded by _mutex
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _readyCondition;
+        std::condition_variable _spaceCondition;
+
+        std::deque<std::unique_ptr<PreparedClip>> _ready;
+
+        bool _stop;
+        bool _prefetchDone;
+
+        // Clip being decoded, only touched by the reading thread
+        std::unique_ptr<PreparedClip> _current;
+
+        // Nothing has been read since the pass started
+        bool _passFresh;
+
+        // Pass counters, readable from any thread
+        std::atomic<int> _clipsStarted;
+        std::atomic<int> _clipsFailed;
+        std::atomic<int> _prefetchStalls;
+
+        void prefetch();
+
+        void startPass();
+        void stopPass();
+
+    public:
+        ClipDataset()
+            : _width(0), _height(0), _frameSkip(1), _prefetchCount(2),
+            _stop(false), _prefetchDone(true), _passFresh(false),
+            _clipsStarted(0), _clipsFailed(0), _prefetchStalls(0)
+        {}
+
+        ~ClipDataset() {
+            stopPass();
+        }
+
+        // Start the first (shuffled) pass over clips, keeping up to prefetchCount clips open ahead
+        void create(const std::vector<std::string> &clips, int width, int height, int frameSkip,
+            int prefetchCount = 2, unsigned long seed = 1234);
+
+        // Read the next frame. sourceFrame receives the frame's index within its clip
+        bool read(unsigned char* planes, int &sourceFrame) override;
+
+        // Start a new pass in a new shuffled order
+        void rewind() override;
+
+        int getNumClips() const {
+            return static_cast<int>(_clips.size());
+        }
+
+        // Clips begun in the current pass
+        int getClipsStarted() const {
+            return _clipsStarted;
+        }
+
+        // Clips in the current pass that could not be opened
+        int getClipsFailed() const {
+            return _clipsFailed;
+        }
+
+        // Times the reader had to wait for the next clip to be opened in the current pass
+        int getPrefetchStalls() const {
+            return _prefetchStalls;
+        }
+    };
+}
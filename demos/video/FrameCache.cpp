@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "FrameCache.h"
+
+#include <util/Simd.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace video;
+
+namespace {
+    const char cacheMagic[4] = { 'O', 'N', 'F', 'C' };
+    const uint32_t cacheVersion = 3;
+}
+
+FrameCacheHeader::FrameCacheHeader()
+    : _version(cacheVersion),
+    _width(0), _height(0), _frameSkip(0), _numFrames(0), _sourceFrames(0)
+{
+    std::memcpy(_magic, cacheMagic, sizeof(_magic));
+    std::memset(_resampler, 0, sizeof(_resampler));
+    std::strncpy(_resampler, util::getSimdName(), sizeof(_resampler) - 1);
+    std::memset(_padding, 0, sizeof(_padding));
+}
+
+std::string FrameCache::getCacheFileName(const std::string &videoFileName, int width, int height, int frameSkip) {
+    return videoFileName + "." + std::to_string(width) + "x" + std::to_string(height) + "s" + std::to_string(frameSkip) + ".framecache";
+}
+
+bool FrameCache::open(const std::string &videoFileName, int width, int height, int frameSkip) {
+    close();
+
+    SourceStamp source;
+
+    if (!source.fromFile(videoFileName))
+        return false;
+
+    if (!_file.open(getCacheFileName(videoFileName, width, height, frameSkip), true))
+        return false;
+
+    if (_file.getSize() < sizeof(FrameCacheHeader)) {
+        close();
+        return false;
+    }
+
+    std::memcpy(&_header, _file.getData(), sizeof(FrameCacheHeader));
+
+    _frameSize = static_cast<size_t>(_header._width) * _header._height * 3;
+
+    bool valid = std::memcmp(_header._magic, cacheMagic, sizeof(cacheMagic)) == 0 &&
+        _header._version == cacheVersion &&
+        std::strncmp(_header._resampler, FrameCacheHeader()._resampler, sizeof(_header._resampler)) == 0 &&
+        _header._source == source &&
+        _header._width == width && _header._height == height &&
+        _header._frameSkip == frameSkip &&
+        _header._numFrames > 0 &&
+        _file.getSize() >= sizeof(FrameCacheHeader) + _frameSize * _header._numFrames;
+
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool FrameCacheWriter::create(const std::string &videoFileName, int width, int height, int frameSkip) {
+    _header = FrameCacheHeader();
+
+    if (!_header._source.fromFile(videoFileName))
+        return false;
+
+    _header._width = width;
+    _header._height = height;
+    _header._frameSkip = frameSkip;
+
+    _fileName = FrameCache::getCacheFileName(videoFileName, width, height, frameSkip);
+    _tempFileName = _fileName + ".tmp";
+
+    _stream.open(_tempFileName, std::ios::binary | std::ios::out | std::ios::trunc);
+
+    if (!_stream.is_open())
+        return false;
+
+    // Placeholder, rewritten once the frame count is known
+    _stream.write(reinterpret_cast<const char*>(&_header), sizeof(FrameCacheHeader));
+
+    return _stream.good();
+}
+
+void FrameCacheWriter::addFrame(const unsigned char* planes) {
+    _stream.write(reinterpret_cast<const char*>(planes), static_cast<std::streamsize>(_header._width) * _header._height * 3);
+
+    _header._numFrames++;
+}
+
+bool FrameCacheWriter::finish(int sourceFrames) {
+    _header._sourceFrames = sourceFrames;
+
+    _stream.seekp(0);
+    _stream.write(reinterpret_cast<const char*>(&_header), sizeof(FrameCacheHeader));
+    _stream.close();
+
+    if (_stream.fail()) {
+        std::remove(_tempFileName.c_str());
+        return false;
+    }
+
+    // rename does not replace an existing file on all platforms
+    std::remove(_fileName.c_str());
+
+    return std::rename(_tempFileName.c_str(), _fileName.c_str()) == 0;
+}
+
+void FrameCacheWriter::abort() {
+    if (!_stream.is_open())
+        return;
+
+    _stream.close();
+
+    std::remove(_tempFileName.c_str());
+}
@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/MappedFile.h>
+
+#include "SourceStamp.h"
+
+#include <fstream>
+#include <string>
+#include <cstdint>
+
+namespace video {
+    // On-disk layout of a frame cache file. Frames follow the header back to back,
+    // each frame stored as planar 8-bit R, G and B planes of width * height bytes
+    struct FrameCacheHeader {
+        char _magic[4];
+        uint32_t _version;
+
+        SourceStamp _source;
+
+        int32_t _width;
+        int32_t _height;
+        int32_t _frameSkip;
+        int32_t _numFrames;
+        int32_t _sourceFrames;
+
+        // CPU kernels the frames were resampled with (util::getSimdName), their rounding can differ
+        char _resampler[8];
+
+        int32_t _padding[3];
+
+        FrameCacheHeader();
+    };
+
+    // Decoded, rescaled video frames streamed from a memory mapped file
+    class FrameCache {
+    private:
+        util::MappedFile _file;
+
+        FrameCacheHeader _header;
+
+        size_t _frameSize;
+
+    public:
+        FrameCache()
+            : _frameSize(0)
+        {}
+
+        // Cache file name for a given video, network input size and frame skip
+        static std::string getCacheFileName(const std::string &videoFileName, int width, int height, int frameSkip);
+
+        // Open an existing cache, fails if it is missing, stale or built with different settings
+        bool open(const std::string &videoFileName, int width, int height, int frameSkip);
+
+        void close() {
+            _file.close();
+        }
+
+        bool isOpen() const {
+            return _file.isOpen();
+        }
+
+        // Number of cached (fed) frames
+        int getNumFrames() const {
+            return _header._numFrames;
+        }
+
+        // Number of frames in the source video, including skipped ones
+        int getSourceFrames() const {
+            return _header._sourceFrames;
+        }
+
+        int getFrameSkip() const {
+            return _header._frameSkip;
+        }
+
+        int getWidth() const {
+            return _header._width;
+        }
+
+        int getHeight() const {
+            return _header._height;
+        }
+
+        // Planar RGB data for a frame, R plane first
+        const unsigned char* getFrame(int index) const {
+            return _file.getData() + sizeof(FrameCacheHeader) + _frameSize * index;
+        }
+    };
+
+    // Writes a frame cache. Data goes to a temporary file that is renamed into place on finish,
+    // so an interrupted build never leaves a truncated cache behind
+    class FrameCacheWriter {
+    private:
+        std::ofstream _stream;
+
+        FrameCacheHeader _header;
+
+        std::string _fileName;
+        std::string _tempFileName;
+
+    public:
+        bool create(const std::string &videoFileName, int width, int height, int frameSkip);
+
+        // Append a frame of planar RGB data (3 * width * height bytes)
+        void addFrame(const unsigned char* planes);
+
+        // Finalize the header and move the cache into place
+        bool finish(int sourceFrames);
+
+        // Discard a partially written cache
+        void abort();
+
+        bool isOpen() const {
+            return _stream.is_open();
+        }
+    };
+}
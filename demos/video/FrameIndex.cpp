@@ -0,0 +1,203 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "FrameIndex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+using namespace video;
+
+namespace {
+    const char indexMagic[4] = { 'O', 'N', 'F', 'I' };
+    const uint32_t indexVersion = 2;
+}
+
+std::string FrameIndex::getIndexFileName(const std::string &videoFileName) {
+    return videoFileName + ".frameindex";
+}
+
+bool FrameIndex::load(const std::string &videoFileName) {
+    SourceStamp source;
+
+    if (!source.fromFile(videoFileName))
+        return false;
+
+    std::ifstream fromFile(getIndexFileName(videoFileName), std::ios::binary | std::ios::in);
+
+    if (!fromFile.is_open())
+        return false;
+
+    char magic[4];
+    uint32_t version;
+    SourceStamp fileSource;
+    int32_t numFrames, numSeekPoints, fromMetadata;
+    double fps;
+
+    fromFile.read(magic, sizeof(magic));
+    fromFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+    fromFile.read(reinterpret_cast<char*>(&fileSource), sizeof(fileSource));
+    fromFile.read(reinterpret_cast<char*>(&numFrames), sizeof(numFrames));
+    fromFile.read(reinterpret_cast<char*>(&numSeekPoints), sizeof(numSeekPoints));
+    fromFile.read(reinterpret_cast<char*>(&fromMetadata), sizeof(fromMetadata));
+    fromFile.read(reinterpret_cast<char*>(&fps), sizeof(fps));
+
+    if (!fromFile.good() || std::memcmp(magic, indexMagic, sizeof(magic)) != 0 || version != indexVersion ||
+        fileSource != source || numFrames <= 0 || numSeekPoints < 0)
+        return false;
+
+    _timestamps.resize(numFrames);
+    _seekPoints.resize(numSeekPoints);
+
+    fromFile.read(reinterpret_cast<char*>(_timestamps.data()), sizeof(double) * numFrames);
+    fromFile.read(reinterpret_cast<char*>(_seekPoints.data()), sizeof(int) * numSeekPoints);
+
+    if (!fromFile.good())
+        return false;
+
+    _source = source;
+    _numFrames = numFrames;
+    _fps = fps;
+    _fromMetadata = fromMetadata != 0;
+
+    return true;
+}
+
+bool FrameIndex::save(const std::string &videoFileName) const {
+    // A crash or a concurrent run never sees a partly written index
+    std::string fileName = getIndexFileName(videoFileName);
+    std::string tempFileName = fileName + ".tmp";
+
+    std::ofstream toFile(tempFileName, std::ios::binary | std::ios::out | std::ios::trunc);
+
+    if (!toFile.is_open())
+        return false;
+
+    int32_t numFrames = _numFrames;
+    int32_t numSeekPoints = static_cast<int32_t>(_seekPoints.size());
+    int32_t fromMetadata = _fromMetadata ? 1 : 0;
+
+    toFile.write(indexMagic, sizeof(indexMagic));
+    toFile.write(reinterpret_cast<const char*>(&indexVersion), sizeof(indexVersion));
+    toFile.write(reinterpret_cast<const char*>(&_source), sizeof(_source));
+    toFile.write(reinterpret_cast<const char*>(&numFrames), sizeof(numFrames));
+    toFile.write(reinterpret_cast<const char*>(&numSeekPoints), sizeof(numSeekPoints));
+    toFile.write(reinterpret_cast<const char*>(&fromMetadata), sizeof(fromMetadata));
+    toFile.write(reinterpret_cast<const char*>(&_fps), sizeof(_fps));
+    toFile.write(reinterpret_cast<const char*>(_timestamps.data()), sizeof(double) * _timestamps.size());
+    toFile.write(reinterpret_cast<const char*>(_seekPoints.data()), sizeof(int) * _seekPoints.size());
+    toFile.close();
+
+    if (toFile.fail()) {
+        std::remove(tempFileName.c_str());
+        return false;
+    }
+
+    // rename does not replace an existing file on all platforms
+    std::remove(fileName.c_str());
+
+    return std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+}
+
+bool FrameIndex::verifyMetadata(cv::VideoCapture &capture) {
+    int count = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_COUNT));
+
+    if (count <= 0 || _fps <= 0.0)
+        return false;
+
+    // The last frame must exist, and nothing may follow it
+    if (!capture.set(cv::CAP_PROP_POS_FRAMES, count - 1) || !capture.grab())
+        return false;
+
+    if (capture.grab())
+        return false;
+
+    _numFrames = count;
+
+    _timestamps.resize(_numFrames);
+
+    for (int i = 0; i < _numFrames; i++)
+        _timestamps[i] = i * 1000.0 / _fps;
+
+    return true;
+}
+
+void FrameIndex::scan(cv::VideoCapture &capture) {
+    capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+
+    _timestamps.clear();
+
+    // grab() demuxes and decodes without retrieving or colour converting the frame
+    while (capture.grab())
+        _timestamps.push_back(capture.get(cv::CAP_PROP_POS_MSEC));
+
+    _numFrames = static_cast<int>(_timestamps.size());
+}
+
+int FrameIndex::getSeekStride() const {
+    // Containers often report no frame rate, assume about one second at 30 fps then
+    const int defaultStride = 30;
+
+    if (!(_fps > 0.0))
+        return defaultStride;
+
+    return std::max(1, static_cast<int>(std::round(_fps)));
+}
+
+void FrameIndex::addSeekPoints() {
+    _seekPoints.clear();
+
+    int stride = getSeekStride();
+
+    for (int i = 0; i < _numFrames; i += stride)
+        _seekPoints.push_back(i);
+}
+
+bool FrameIndex::build(const std::string &videoFileName, cv::VideoCapture &capture) {
+    if (!_source.fromFile(videoFileName))
+        return false;
+
+    _fps = capture.get(cv::CAP_PROP_FPS);
+
+    _fromMetadata = verifyMetadata(capture);
+
+    if (!_fromMetadata)
+        scan(capture);
+
+    addSeekPoints();
+
+    capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+
+    return _numFrames > 0;
+}
+
+bool FrameIndex::loadOrBuild(const std::string &videoFileName, cv::VideoCapture &capture) {
+    if (load(videoFileName))
+        return true;
+
+    if (!build(videoFileName, capture))
+        return false;
+
+    // A read-only resources directory only costs a rebuild next run
+    save(videoFileName);
+
+    return true;
+}
+
+int FrameIndex::findSeekPoint(int frame) const {
+    std::vector<int>::const_iterator it = std::upper_bound(_seekPoints.begin(), _seekPoints.end(), frame);
+
+    if (it == _seekPoints.begin())
+        return 0;
+
+    return *(it - 1);
+}
@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui.hpp>
+
+#include "SourceStamp.h"
+
+#include <string>
+#include <vector>
+
+namespace video {
+    // Frame count, per frame timestamps and seek points of a video, persisted in a sidecar file.
+    // Seek points are evenly spaced frame numbers, one per stride (about one second of video).
+    // They are not key frames: VideoCapture does not report packet key frame flags, so a seek to
+    // one may still decode from an earlier key frame
+    class FrameIndex {
+    private:
+        SourceStamp _source;
+
+        int _numFrames;
+        double _fps;
+
+        // Whether the count came from verified container metadata instead of a scan
+        bool _fromMetadata;
+
+        // Presentation time of each frame in milliseconds
+        std::vector<double> _timestamps;
+
+        // Evenly spaced frame numbers, every getSeekStride() frames
+        std::vector<int> _seekPoints;
+
+        bool verifyMetadata(cv::VideoCapture &capture);
+        void scan(cv::VideoCapture &capture);
+        void addSeekPoints();
+
+    public:
+        FrameIndex()
+            : _numFrames(0), _fps(0.0), _fromMetadata(false)
+        {}
+
+        static std::string getIndexFileName(const std::string &videoFileName);
+
+        // Load an existing index, fails if it is missing or the video has changed
+        bool load(const std::string &videoFileName);
+
+        // Write the sidecar to a temporary file and rename it into place
+        bool save(const std::string &videoFileName) const;
+
+        // Build the index. Container metadata is used when it can be confirmed with two seeks,
+        // otherwise the video is scanned with grab() only (no frame retrieval or colour conversion).
+        // The capture is rewound to the first frame afterwards
+        bool build(const std::string &videoFileName, cv::VideoCapture &capture);
+
+        // Load the sidecar if present and current, otherwise build and save it
+        bool loadOrBuild(const std::string &videoFileName, cv::VideoCapture &capture);
+
+        int getNumFrames() const {
+            return _numFrames;
+        }
+
+        double getFps() const {
+            return _fps;
+        }
+
+        bool isFromMetadata() const {
+            return _fromMetadata;
+        }
+
+        const std::vector<double> &getTimestamps() const {
+            return _timestamps;
+        }
+
+        const std::vector<int> &getSeekPoints() const {
+            return _seekPoints;
+        }
+
+        // Distance between seek points in frames, a fixed 30 when the frame rate is unknown
+        int getSeekStride() const;
+
+        // Last seek point at or before frame
+        int findSeekPoint(int frame) const;
+    };
+}
@@ -0,0 +1,135 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "FramePipeline.h"
+
+#include <chrono>
+
+using namespace video;
+
+void FramePipeline::create(int width, int height, int capacity) {
+    stop();
+
+    PipelineFrame prototype;
+    prototype._planes.resize(width * height * 3);
+
+    _queue.create(capacity, prototype);
+
+    resetStats();
+}
+
+void FramePipeline::start(FrameSource &source) {
+    stop();
+
+    _stop = false;
+    _finished = false;
+
+    _thread = std::thread(&FramePipeline::produce, this, &source);
+}
+
+void FramePipeline::produce(FrameSource* source) {
+    while (!_stop) {
+        PipelineFrame* frame = _queue.beginPush();
+
+        if (frame == nullptr) {
+            _producerStalls++;
+
+            int spins = 0;
+
+            while (!_stop && (frame = _queue.beginPush()) == nullptr)
+                util::backOff(spins);
+
+            if (frame == nullptr)
+                break;
+        }
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+        if (!source->read(frame->_planes.data(), frame->_sourceFrame))
+            break;
+
+        std::chrono::duration<float> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        frame->_decodeSeconds = elapsed.count();
+
+        _queue.endPush();
+
+        _framesProduced++;
+    }
+
+    _finished = true;
+}
+
+const PipelineFrame* FramePipeline::acquire() {
+    PipelineFrame* frame = _queue.front();
+
+    if (frame == nullptr) {
+        // Finished must be checked before the final look at the queue, frames pushed before it was set are still delivered
+        bool stalled = false;
+        int spins = 0;
+
+        for (;;) {
+            bool finished = _finished;
+
+            frame = _queue.front();
+
+            if (frame != nullptr || finished)
+                break;
+
+            stalled = true;
+
+            util::backOff(spins);
+        }
+
+        if (stalled)
+            _consumerStalls++;
+
+        if (frame == nullptr)
+            return nullptr;
+    }
+
+    _occupancyTotal += _queue.size();
+    _occupancySamples++;
+
+    return frame;
+}
+
+void FramePipeline::release() {
+    _queue.pop();
+}
+
+void FramePipeline::stop() {
+    _stop = true;
+
+    if (_thread.joinable())
+        _thread.join();
+
+    // Drop anything left over from an interrupted pass
+    while (_queue.front() != nullptr)
+        _queue.pop();
+}
+
+PipelineStats FramePipeline::getStats() const {
+    PipelineStats stats;
+
+    stats._framesProduced = _framesProduced;
+    stats._producerStalls = _producerStalls;
+    stats._consumerStalls = _consumerStalls;
+    stats._averageOccupancy = _occupancySamples > 0 ? static_cast<float>(_occupancyTotal) / _occupancySamples : 0.0f;
+    stats._capacity = static_cast<int>(_queue.getCapacity());
+
+    return stats;
+}
+
+void FramePipeline::resetStats() {
+    _framesProduced = 0;
+    _producerStalls = 0;
+    _consumerStalls = 0;
+    _occupancyTotal = 0;
+    _occupancySamples = 0;
+}
@@ -0,0 +1,105 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/SpscQueue.h>
+
+#include "FrameSource.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace video {
+    // A decoded frame waiting in the pipeline
+    struct PipelineFrame {
+        std::vector<unsigned char> _planes;
+
+        // Index of the frame in the source video
+        int _sourceFrame;
+
+        // Time the producer spent reading the frame
+        float _decodeSeconds;
+
+        PipelineFrame()
+            : _sourceFrame(0), _decodeSeconds(0.0f)
+        {}
+    };
+
+    // Counters describing which side of the pipeline is waiting on the other
+    struct PipelineStats {
+        uint64_t _framesProduced;
+
+        // Times the decoder found the queue full (training is the bottleneck)
+        uint64_t _producerStalls;
+
+        // Times training found the queue empty (decoding is the bottleneck)
+        uint64_t _consumerStalls;
+
+        // Mean queue occupancy seen by the consumer, in frames
+        float _averageOccupancy;
+
+        int _capacity;
+
+        PipelineStats()
+            : _framesProduced(0), _producerStalls(0), _consumerStalls(0), _averageOccupancy(0.0f), _capacity(0)
+        {}
+    };
+
+    // Decodes frames on a background thread into a bounded lock-free ring,
+    // so reading and converting frames overlaps with hierarchy compute
+    class FramePipeline {
+    private:
+        util::SpscQueue<PipelineFrame> _queue;
+
+        std::thread _thread;
+
+        std::atomic<bool> _stop;
+        std::atomic<bool> _finished;
+
+        std::atomic<uint64_t> _framesProduced;
+        std::atomic<uint64_t> _producerStalls;
+
+        uint64_t _consumerStalls;
+        uint64_t _occupancyTotal;
+        uint64_t _occupancySamples;
+
+        void produce(FrameSource* source);
+
+    public:
+        FramePipeline()
+            : _stop(false), _finished(true), _framesProduced(0), _producerStalls(0),
+            _consumerStalls(0), _occupancyTotal(0), _occupancySamples(0)
+        {}
+
+        ~FramePipeline() {
+            stop();
+        }
+
+        // Preallocate capacity frames of planar RGB at the given size
+        void create(int width, int height, int capacity);
+
+        // Start producing one pass of frames from source on the decode thread
+        void start(FrameSource &source);
+
+        // Next frame, waiting for the decoder if needed. Returns nullptr once the pass has ended
+        const PipelineFrame* acquire();
+
+        // Hand the frame returned by acquire back to the decoder
+        void release();
+
+        // Stop the decode thread, discarding queued frames
+        void stop();
+
+        PipelineStats getStats() const;
+
+        void resetStats();
+    };
+}
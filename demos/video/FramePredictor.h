@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/InputStaging.h>
+
+namespace video {
+    // Next frame predictor over planar float RGB (channel 0 = R, 1 = G, 2 = B) at a fixed frame size
+    class FramePredictor {
+    public:
+        virtual ~FramePredictor() {}
+
+        // Input planes, written in place before activate
+        virtual float* getInputData(int channel) = 0;
+
+        // Prediction of the next frame, valid until the next activate
+        virtual const float* getPredictionData(int channel) const = 0;
+
+        virtual void activate() = 0;
+
+        virtual void learn() = 0;
+
+        // Copy the predictions into the inputs, for running on its own output
+        virtual void feedBackPredictions() = 0;
+    };
+
+    // A single hierarchy with three staged input layers
+    class HierarchyFramePredictor : public FramePredictor {
+    private:
+        util::InputStaging* _staging;
+
+    public:
+        HierarchyFramePredictor(util::InputStaging &staging)
+            : _staging(&staging)
+        {}
+
+        float* getInputData(int channel) override {
+            return _staging->getInputData(channel);
+        }
+
+        const float* getPredictionData(int channel) const override {
+            return _staging->getPredictionData(channel);
+        }
+
+        void activate() override {
+            _staging->activate();
+        }
+
+        void learn() override {
+            _staging->learn();
+        }
+
+        void feedBackPredictions() override {
+            _staging->feedBackPredictions();
+        }
+    };
+}
@@ -0,0 +1,168 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "FrameQuality.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace video;
+
+namespace {
+    const float byteInv = 1.0f / 255.0f;
+
+    const int windowSize = 11;
+    const float windowSigma = 1.5f;
+
+    // Stabilizing constants for a dynamic range of 1
+    const float c1 = 0.01f * 0.01f;
+    const float c2 = 0.03f * 0.03f;
+
+    inline float clamp01(float v) {
+        return std::min(1.0f, std::max(0.0f, v));
+    }
+
+    inline float luma(float r, float g, float b) {
+        return 0.299f * r + 0.587f * g + 0.114f * b;
+    }
+
+    inline float ssimFromMoments(float meanX, float meanY, float meanXX, float meanYY, float meanXY) {
+        float varianceX = meanXX - meanX * meanX;
+        float varianceY = meanYY - meanY * meanY;
+        float covariance = meanXY - meanX * meanY;
+
+        return ((2.0f * meanX * meanY + c1) * (2.0f * covariance + c2)) /
+            ((meanX * meanX + meanY * meanY + c1) * (varianceX + varianceY + c2));
+    }
+}
+
+float video::computePSNR(const float* predR, const float* predG, const float* predB,
+    const unsigned char* truthPlanes, int width, int height)
+{
+    int count = width * height;
+
+    const unsigned char* truthR = truthPlanes;
+    const unsigned char* truthG = truthPlanes + count;
+    const unsigned char* truthB = truthPlanes + count * 2;
+
+    double sum = 0.0;
+
+    for (int i = 0; i < count; i++) {
+        float er = clamp01(predR[i]) - truthR[i] * byteInv;
+        float eg = clamp01(predG[i]) - truthG[i] * byteInv;
+        float eb = clamp01(predB[i]) - truthB[i] * byteInv;
+
+        sum += er * er + eg * eg + eb * eb;
+    }
+
+    double mse = sum / (count * 3.0);
+
+    if (mse <= 1e-10)
+        return 100.0f;
+
+    return static_cast<float>(-10.0 * std::log10(mse));
+}
+
+float video::computeSSIM(const float* predR, const float* predG, const float* predB,
+    const unsigned char* truthPlanes, int width, int height)
+{
+    int count = width * height;
+
+    const unsigned char* truthR = truthPlanes;
+    const unsigned char* truthG = truthPlanes + count;
+    const unsigned char* truthB = truthPlanes + count * 2;
+
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+
+    for (int i = 0; i < count; i++) {
+        x[i] = luma(clamp01(predR[i]), clamp01(predG[i]), clamp01(predB[i]));
+        y[i] = luma(truthR[i] * byteInv, truthG[i] * byteInv, truthB[i] * byteInv);
+    }
+
+    if (width < windowSize || height < windowSize) {
+        double sx = 0.0, sy = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0;
+
+        for (int i = 0; i < count; i++) {
+            sx += x[i];
+            sy += y[i];
+            sxx += x[i] * x[i];
+            syy += y[i] * y[i];
+            sxy += x[i] * y[i];
+        }
+
+        return ssimFromMoments(static_cast<float>(sx / count), static_cast<float>(sy / count),
+            static_cast<float>(sxx / count), static_cast<float>(syy / count), static_cast<float>(sxy / count));
+    }
+
+    float weights[windowSize];
+    float weightSum = 0.0f;
+
+    for (int k = 0; k < windowSize; k++) {
+        float d = static_cast<float>(k - windowSize / 2);
+
+        weights[k] = std::exp(-d * d / (2.0f * windowSigma * windowSigma));
+
+        weightSum += weights[k];
+    }
+
+    for (int k = 0; k < windowSize; k++)
+        weights[k] /= weightSum;
+
+    // Separable filtering of the five moments, horizontal pass over the valid columns
+    int validWidth = width - windowSize + 1;
+    int validHeight = height - windowSize + 1;
+
+    std::vector<float> moments(height * validWidth * 5);
+
+    for (int row = 0; row < height; row++)
+        for (int col = 0; col < validWidth; col++) {
+            float mx = 0.0f, my = 0.0f, mxx = 0.0f, myy = 0.0f, mxy = 0.0f;
+
+            const float* xs = &x[col + row * width];
+            const float* ys = &y[col + row * width];
+
+            for (int k = 0; k < windowSize; k++) {
+                float w = weights[k];
+
+                mx += w * xs[k];
+                my += w * ys[k];
+                mxx += w * xs[k] * xs[k];
+                myy += w * ys[k] * ys[k];
+                mxy += w * xs[k] * ys[k];
+            }
+
+            float* m = &moments[(col + row * validWidth) * 5];
+
+            m[0] = mx;
+            m[1] = my;
+            m[2] = mxx;
+            m[3] = myy;
+            m[4] = mxy;
+        }
+
+    // Vertical pass, accumulating the similarity of each window
+    double ssimSum = 0.0;
+
+    for (int row = 0; row < validHeight; row++)
+        for (int col = 0; col < validWidth; col++) {
+            float m[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+            for (int k = 0; k < windowSize; k++) {
+                const float* src = &moments[(col + (row + k) * validWidth) * 5];
+
+                for (int j = 0; j < 5; j++)
+                    m[j] += weights[k] * src[j];
+            }
+
+            ssimSum += ssimFromMoments(m[0], m[1], m[2], m[3], m[4]);
+        }
+
+    return static_cast<float>(ssimSum / (validWidth * validHeight));
+}
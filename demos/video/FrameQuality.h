@@ -0,0 +1,23 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+namespace video {
+    // Image quality of a predicted frame (planar float RGB, clamped to [0, 1] before comparing)
+    // against the true frame (planar 8-bit RGB). Both are width x height
+
+    // Peak signal to noise ratio over all channels in dB, capped at 100 for identical frames
+    float computePSNR(const float* predR, const float* predG, const float* predB,
+        const unsigned char* truthPlanes, int width, int height);
+
+    // Mean structural similarity of the luma (BT.601) images, using an 11x11 Gaussian window
+    // (sigma 1.5) over the valid region. Frames smaller than the window are compared as one window
+    float computeSSIM(const float* predR, const float* predG, const float* predB,
+        const unsigned char* truthPlanes, int width, int height);
+}
@@ -0,0 +1,63 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "FrameSource.h"
+
+#include <cstring>
+
+using namespace video;
+
+bool CacheFrameSource::read(unsigned char* planes, int &sourceFrame) {
+    if (_next >= (_schedule != nullptr ? static_cast<int>(_schedule->size()) : _cache->getNumFrames()))
+        return false;
+
+    int frame = _schedule != nullptr ? (*_schedule)[_next] : _next;
+
+    std::memcpy(planes, _cache->getFrame(frame), _cache->getWidth() * _cache->getHeight() * 3);
+
+    sourceFrame = (frame + 1) * _cache->getFrameSkip() - 1;
+
+    _next++;
+
+    return true;
+}
+
+bool CaptureFrameSource::read(unsigned char* planes, int &sourceFrame) {
+    int target = _position + _frameSkip - 1;
+
+    if (_numFrames > 0 && target >= _numFrames)
+        return false;
+
+    // Advance without colour conversion up to and including the fed frame
+    while (_position <= target) {
+        if (!_capture->grab())
+            return false;
+
+        _position++;
+
+        _numGrabs++;
+    }
+
+    if (!_capture->retrieve(_frame) || _frame.empty())
+        return false;
+
+    _resampler->resample(_frame.data, _frame.step, planes);
+
+    if (_cacheWriter != nullptr)
+        _cacheWriter->addFrame(planes);
+
+    sourceFrame = target;
+
+    return true;
+}
+
+void CaptureFrameSource::rewind() {
+    _capture->set(cv::CAP_PROP_POS_FRAMES, 0);
+
+    _position = 0;
+}
@@ -0,0 +1,110 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui.hpp>
+
+#include "FrameCache.h"
+#include "Resampler.h"
+
+#include <vector>
+
+namespace video {
+    // A sequence of ready-to-feed frames, planar 8-bit RGB at the network input size
+    class FrameSource {
+    public:
+        virtual ~FrameSource() {}
+
+        // Read the next fed frame into planes (3 * width * height bytes).
+        // sourceFrame receives the frame's index in the source video. Returns false at the end
+        virtual bool read(unsigned char* planes, int &sourceFrame) = 0;
+
+        // Restart from the first frame
+        virtual void rewind() = 0;
+    };
+
+    // Frames streamed from a memory mapped frame cache, in order or following a schedule of cached frame indices
+    class CacheFrameSource : public FrameSource {
+    private:
+        const FrameCache* _cache;
+
+        const std::vector<int>* _schedule;
+
+        int _next;
+
+    public:
+        CacheFrameSource(const FrameCache &cache)
+            : _cache(&cache), _schedule(nullptr), _next(0)
+        {}
+
+        // Feed the scheduled frames instead of every frame in order (nullptr to go back),
+        // the schedule must outlive its use
+        void setSchedule(const std::vector<int>* schedule) {
+            _schedule = schedule;
+        }
+
+        bool read(unsigned char* planes, int &sourceFrame) override;
+
+        void rewind() override {
+            _next = 0;
+        }
+    };
+
+    // Frames decoded from a video, keeping every frameSkip'th frame.
+    // Skipped frames are only grabbed, the fed frame is the only one retrieved (colour converted).
+    // Optionally writes the fed frames to a frame cache as they are decoded
+    class CaptureFrameSource : public FrameSource {
+    private:
+        cv::VideoCapture* _capture;
+        Resampler* _resampler;
+
+        FrameCacheWriter* _cacheWriter;
+
+        int _frameSkip;
+
+        // Known frame count of the video, 0 to read until the capture ends
+        int _numFrames;
+
+        // Frames consumed from the capture since the last rewind
+        int _position;
+
+        // Work counter since construction
+        int _numGrabs;
+
+        cv::Mat _frame;
+
+    public:
+        CaptureFrameSource(cv::VideoCapture &capture, Resampler &resampler, int frameSkip)
+            : _capture(&capture), _resampler(&resampler), _cacheWriter(nullptr),
+            _frameSkip(frameSkip), _numFrames(0), _position(0), _numGrabs(0)
+        {}
+
+        void setCacheWriter(FrameCacheWriter* cacheWriter) {
+            _cacheWriter = cacheWriter;
+        }
+
+        // Stop at a known frame count (e.g. from a FrameIndex) instead of at the first failed grab
+        void setNumFrames(int numFrames) {
+            _numFrames = numFrames;
+        }
+
+        bool read(unsigned char* planes, int &sourceFrame) override;
+
+        void rewind() override;
+
+        int getPosition() const {
+            return _position;
+        }
+
+        int getNumGrabs() const {
+            return _numGrabs;
+        }
+    };
+}
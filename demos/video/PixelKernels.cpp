@@ -0,0 +1,311 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "PixelKernels.h"
+
+#include <util/Simd.h>
+
+#include <algorithm>
+
+using namespace video;
+
+namespace {
+    const float byteInv = 1.0f / 255.0f;
+
+    // BT.601 full range, chroma offset by 0.5 so all planes lie in [0, 1]
+    const float lumaR = 0.299f;
+    const float lumaB = 0.114f;
+    const float lumaG = 1.0f - lumaR - lumaB;
+    const float chromaU = 0.5f / (1.0f - lumaB);
+    const float chromaV = 0.5f / (1.0f - lumaR);
+
+    // Scalar tail shared by both layouts, returns the summed channel squared error
+    inline float encodePixel(float r, float g, float b,
+        float pr, float pg, float pb,
+        float &ir, float &ig, float &ib, float keep, float blendPred)
+    {
+        float er = r - pr;
+        float eg = g - pg;
+        float eb = b - pb;
+
+        ir = r * keep + pr * blendPred;
+        ig = g * keep + pg * blendPred;
+        ib = b * keep + pb * blendPred;
+
+        return er * er + eg * eg + eb * eb;
+    }
+
+#if defined(DEMOS_SIMD_AVX2)
+    // Encode 8 pixels of one channel, accumulating squared error
+    inline __m256 encodeChannel(__m256 value, const float* pred, float* input, __m256 keep, __m256 blend, __m256 error) {
+        __m256 p = _mm256_loadu_ps(pred);
+        __m256 e = _mm256_sub_ps(value, p);
+
+        _mm256_storeu_ps(input, _mm256_fmadd_ps(value, keep, _mm256_mul_ps(p, blend)));
+
+        return _mm256_fmadd_ps(e, e, error);
+    }
+
+    inline float horizontalSum(__m256 v) {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+
+        return _mm_cvtss_f32(s);
+    }
+
+    inline __m256 loadBytes(const unsigned char* src) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+    }
+#elif defined(DEMOS_SIMD_NEON)
+    inline float32x4_t encodeChannel(float32x4_t value, const float* pred, float* input, float32x4_t keep, float32x4_t blend, float32x4_t error) {
+        float32x4_t p = vld1q_f32(pred);
+        float32x4_t e = vsubq_f32(value, p);
+
+        vst1q_f32(input, vmlaq_f32(vmulq_f32(p, blend), value, keep));
+
+        return vmlaq_f32(error, e, e);
+    }
+
+    inline float horizontalSum(float32x4_t v) {
+        float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+
+    // Widen 8 bytes to two vectors of 4 floats
+    inline void loadBytes(uint8x8_t bytes, float32x4_t &lo, float32x4_t &hi) {
+        uint16x8_t words = vmovl_u8(bytes);
+
+        lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(words)));
+        hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(words)));
+    }
+#endif
+}
+
+float video::encodeFramePlanar(const unsigned char* planes, int count,
+    const float* predR, const float* predG, const float* predB,
+    float* inputR, float* inputG, float* inputB, float blendPred)
+{
+    const unsigned char* srcR = planes;
+    const unsigned char* srcG = planes + count;
+    const unsigned char* srcB = planes + count * 2;
+
+    const float keep = 1.0f - blendPred;
+
+    float error = 0.0f;
+
+    int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+    __m256 scale = _mm256_set1_ps(byteInv);
+    __m256 keepV = _mm256_set1_ps(keep);
+    __m256 blendV = _mm256_set1_ps(blendPred);
+    __m256 errorV = _mm256_setzero_ps();
+
+    for (; i + 8 <= count; i += 8) {
+        errorV = encodeChannel(_mm256_mul_ps(loadBytes(srcR + i), scale), predR + i, inputR + i, keepV, blendV, errorV);
+        errorV = encodeChannel(_mm256_mul_ps(loadBytes(srcG + i), scale), predG + i, inputG + i, keepV, blendV, errorV);
+        errorV = encodeChannel(_mm256_mul_ps(loadBytes(srcB + i), scale), predB + i, inputB + i, keepV, blendV, errorV);
+    }
+
+    error = horizontalSum(errorV);
+#elif defined(DEMOS_SIMD_NEON)
+    float32x4_t keepV = vdupq_n_f32(keep);
+    float32x4_t blendV = vdupq_n_f32(blendPred);
+    float32x4_t errorV = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= count; i += 8) {
+        const unsigned char* srcs[3] = { srcR, srcG, srcB };
+        const float* preds[3] = { predR, predG, predB };
+        float* inputs[3] = { inputR, inputG, inputB };
+
+        for (int c = 0; c < 3; c++) {
+            float32x4_t lo, hi;
+            loadBytes(vld1_u8(srcs[c] + i), lo, hi);
+
+            errorV = encodeChannel(vmulq_n_f32(lo, byteInv), preds[c] + i, inputs[c] + i, keepV, blendV, errorV);
+            errorV = encodeChannel(vmulq_n_f32(hi, byteInv), preds[c] + i + 4, inputs[c] + i + 4, keepV, blendV, errorV);
+        }
+    }
+
+    error = horizontalSum(errorV);
+#endif
+
+    for (; i < count; i++)
+        error += encodePixel(srcR[i] * byteInv, srcG[i] * byteInv, srcB[i] * byteInv,
+            predR[i], predG[i], predB[i], inputR[i], inputG[i], inputB[i], keep, blendPred);
+
+    return error / 3.0f;
+}
+
+float video::encodeFrameBGR(const unsigned char* bgr, int count,
+    const float* predR, const float* predG, const float* predB,
+    float* inputR, float* inputG, float* inputB, float blendPred)
+{
+    const float keep = 1.0f - blendPred;
+
+    float error = 0.0f;
+
+    int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+    __m256 scale = _mm256_set1_ps(byteInv);
+    __m256 keepV = _mm256_set1_ps(keep);
+    __m256 blendV = _mm256_set1_ps(blendPred);
+    __m256 errorV = _mm256_setzero_ps();
+
+    // Each gathered dword holds B, G, R and the next pixel's B
+    __m256i offsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    __m256i byteMask = _mm256_set1_epi32(0xff);
+
+    // One extra pixel of headroom since each gather reads 4 bytes
+    for (; i + 9 <= count; i += 8) {
+        __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(bgr + i * 3), offsets, 1);
+
+        __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(pixels, byteMask)), scale);
+        __m256 g = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), byteMask)), scale);
+        __m256 r = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), byteMask)), scale);
+
+        errorV = encodeChannel(r, predR + i, inputR + i, keepV, blendV, errorV);
+        errorV = encodeChannel(g, predG + i, inputG + i, keepV, blendV, errorV);
+        errorV = encodeChannel(b, predB + i, inputB + i, keepV, blendV, errorV);
+    }
+
+    error = horizontalSum(errorV);
+#elif defined(DEMOS_SIMD_NEON)
+    float32x4_t keepV = vdupq_n_f32(keep);
+    float32x4_t blendV = vdupq_n_f32(blendPred);
+    float32x4_t errorV = vdupq_n_f32(0.0f);
+
+    for (; i + 8 <= count; i += 8) {
+        // Structured load deinterleaves B, G, R
+        uint8x8x3_t pixels = vld3_u8(bgr + i * 3);
+
+        const float* preds[3] = { predB, predG, predR };
+        float* inputs[3] = { inputB, inputG, inputR };
+
+        for (int c = 0; c < 3; c++) {
+            float32x4_t lo, hi;
+            loadBytes(pixels.val[c], lo, hi);
+
+            errorV = encodeChannel(vmulq_n_f32(lo, byteInv), preds[c] + i, inputs[c] + i, keepV, blendV, errorV);
+            errorV = encodeChannel(vmulq_n_f32(hi, byteInv), preds[c] + i + 4, inputs[c] + i + 4, keepV, blendV, errorV);
+        }
+    }
+
+    error = horizontalSum(errorV);
+#endif
+
+    for (; i < count; i++)
+        error += encodePixel(bgr[i * 3 + 2] * byteInv, bgr[i * 3 + 1] * byteInv, bgr[i * 3] * byteInv,
+            predR[i], predG[i], predB[i], inputR[i], inputG[i], inputB[i], keep, blendPred);
+
+    return error / 3.0f;
+}
+
+void video::decodePredictionRGBA(const float* predR, const float* predG, const float* predB, int count, unsigned char* rgba) {
+    int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+    __m256 zero = _mm256_setzero_ps();
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 byteMax = _mm256_set1_ps(255.0f);
+    __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xff000000));
+
+    // Pack each pixel into one little endian dword, R in the lowest byte
+    for (; i + 8 <= count; i += 8) {
+        __m256i r = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(predR + i), zero), one), byteMax));
+        __m256i g = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(predG + i), zero), one), byteMax));
+        __m256i b = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(predB + i), zero), one), byteMax));
+
+        __m256i pixels = _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)), _mm256_or_si256(_mm256_slli_epi32(b, 16), alpha));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4), pixels);
+    }
+#elif defined(DEMOS_SIMD_NEON)
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t one = vdupq_n_f32(1.0f);
+
+    for (; i + 8 <= count; i += 8) {
+        const float* preds[3] = { predR, predG, predB };
+
+        uint8x8x4_t pixels;
+        pixels.val[3] = vdup_n_u8(0xff);
+
+        for (int c = 0; c < 3; c++) {
+            uint32x4_t lo = vcvtq_u32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(preds[c] + i), zero), one), 255.0f));
+            uint32x4_t hi = vcvtq_u32_f32(vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(preds[c] + i + 4), zero), one), 255.0f));
+
+            pixels.val[c] = vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+        }
+
+        // Structured store interleaves R, G, B, A
+        vst4_u8(rgba + i * 4, pixels);
+    }
+#endif
+
+    for (; i < count; i++) {
+        rgba[i * 4 + 0] = static_cast<unsigned char>(255.0f * std::min(1.0f, std::max(0.0f, predR[i])));
+        rgba[i * 4 + 1] = static_cast<unsigned char>(255.0f * std::min(1.0f, std::max(0.0f, predG[i])));
+        rgba[i * 4 + 2] = static_cast<unsigned char>(255.0f * std::min(1.0f, std::max(0.0f, predB[i])));
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+void video::convertRGBToYUV420(const float* r, const float* g, const float* b, int width, int height,
+    float* y, float* u, float* v)
+{
+    const int chromaWidth = (width + 1) / 2;
+
+    for (int i = 0; i < width * height; i++)
+        y[i] = lumaR * r[i] + lumaG * g[i] + lumaB * b[i];
+
+    // Chroma is linear, so the chroma of the block mean RGB is the mean of the block chroma
+    for (int cy = 0; cy < (height + 1) / 2; cy++) {
+        int row0 = cy * 2 * width;
+        int row1 = std::min(cy * 2 + 1, height - 1) * width;
+
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int x0 = cx * 2;
+            int x1 = std::min(x0 + 1, width - 1);
+
+            float br = 0.25f * (r[row0 + x0] + r[row0 + x1] + r[row1 + x0] + r[row1 + x1]);
+            float bg = 0.25f * (g[row0 + x0] + g[row0 + x1] + g[row1 + x0] + g[row1 + x1]);
+            float bb = 0.25f * (b[row0 + x0] + b[row0 + x1] + b[row1 + x0] + b[row1 + x1]);
+
+            float by = lumaR * br + lumaG * bg + lumaB * bb;
+
+            u[cx + cy * chromaWidth] = (bb - by) * chromaU + 0.5f;
+            v[cx + cy * chromaWidth] = (br - by) * chromaV + 0.5f;
+        }
+    }
+}
+
+void video::convertYUV420ToRGB(const float* y, const float* u, const float* v, int width, int height,
+    float* r, float* g, float* b)
+{
+    const int chromaWidth = (width + 1) / 2;
+
+    for (int py = 0; py < height; py++) {
+        const float* rowU = u + (py / 2) * chromaWidth;
+        const float* rowV = v + (py / 2) * chromaWidth;
+
+        for (int px = 0; px < width; px++) {
+            int i = px + py * width;
+
+            float dr = (rowV[px / 2] - 0.5f) / chromaV;
+            float db = (rowU[px / 2] - 0.5f) / chromaU;
+
+            r[i] = y[i] + dr;
+            b[i] = y[i] + db;
+            g[i] = y[i] - (lumaR * dr + lumaB * db) / lumaG;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+namespace video {
+    // Fused per frame input kernels. In a single pass each pixel is normalized to [0, 1],
+    // its squared error against the previous prediction is accumulated, and the input is
+    // corrupted by blending in the prediction: input = pixel * (1 - blendPred) + pred * blendPred.
+    // The returned error is the sum over pixels of the channel mean squared error
+
+    // Planar 8-bit RGB source (R plane first, count bytes per plane)
+    float encodeFramePlanar(const unsigned char* planes, int count,
+        const float* predR, const float* predG, const float* predB,
+        float* inputR, float* inputG, float* inputB, float blendPred);
+
+    // Interleaved 8-bit BGR source (OpenCV layout), deinterleaved into the planar inputs
+    float encodeFrameBGR(const unsigned char* bgr, int count,
+        const float* predR, const float* predG, const float* predB,
+        float* inputR, float* inputG, float* inputB, float blendPred);
+
+    // Planar float predictions to interleaved 8-bit RGBA (opaque), clamped to [0, 1] and
+    // truncated like the previous per pixel sf::Color conversion
+    void decodePredictionRGBA(const float* predR, const float* predG, const float* predB, int count, unsigned char* rgba);
+
+    // Planar float RGB to full resolution luma and 2x2 box subsampled chroma (BT.601, U and V offset by 0.5).
+    // Chroma planes are (width + 1) / 2 x (height + 1) / 2
+    void convertRGBToYUV420(const float* r, const float* g, const float* b, int width, int height,
+        float* y, float* u, float* v);
+
+    // Inverse of convertRGBToYUV420 with nearest chroma upsampling, unclamped
+    void convertYUV420ToRGB(const float* y, const float* u, const float* v, int width, int height,
+        float* r, float* g, float* b);
+}
@@ -0,0 +1,121 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "ReplayScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace video;
+
+void ReplayScheduler::create(int numFrames, int segmentLength, float convergedRatio, int maxReplays, int revisitPasses) {
+    _numFrames = numFrames;
+    _segmentLength = std::max(1, segmentLength);
+    _convergedRatio = convergedRatio;
+    _maxReplays = std::max(1, maxReplays);
+    _revisitPasses = std::max(1, revisitPasses);
+
+    _lastVisited.assign((_numFrames + _segmentLength - 1) / _segmentLength, 0);
+
+    _schedule.clear();
+}
+
+int ReplayScheduler::plan(const std::vector<float> &frameErrors, int pass) {
+    const int numSegments = getNumSegments();
+
+    std::vector<float> segmentErrors(numSegments, 0.0f);
+
+    float meanError = 0.0f;
+
+    for (int s = 0; s < numSegments; s++) {
+        int first = s * _segmentLength;
+        int last = std::min(_numFrames, first + _segmentLength);
+
+        for (int f = first; f < last; f++)
+            segmentErrors[s] += frameErrors[f];
+
+        segmentErrors[s] /= last - first;
+
+        meanError += segmentErrors[s];
+    }
+
+    meanError /= std::max(1, numSegments);
+
+    // Wanted replays of each segment, 0 for skipped
+    std::vector<int> wanted(numSegments, 0);
+
+    for (int s = 0; s < numSegments; s++) {
+        bool converged = segmentErrors[s] < _convergedRatio * meanError;
+
+        if (converged && pass - _lastVisited[s] < _revisitPasses)
+            continue;
+
+        wanted[s] = meanError > 0.0f ? std::min(_maxReplays, std::max(1, static_cast<int>(std::round(segmentErrors[s] / meanError)))) : 1;
+    }
+
+    // Grant replays round by round, highest error first, within the budget of one uniform sweep
+    std::vector<int> order(numSegments);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return segmentErrors[a] > segmentErrors[b]; });
+
+    std::vector<int> granted(numSegments, 0);
+
+    int budget = _numFrames;
+
+    for (int round = 1; round <= _maxReplays; round++)
+        for (int s : order) {
+            int length = std::min(_numFrames, (s + 1) * _segmentLength) - s * _segmentLength;
+
+            if (wanted[s] >= round && length <= budget) {
+                granted[s]++;
+                budget -= length;
+            }
+        }
+
+    _schedule.clear();
+
+    _segmentsSkipped = 0;
+    _segmentsReplayed = 0;
+
+    for (int s = 0; s < numSegments; s++) {
+        if (granted[s] == 0) {
+            _segmentsSkipped++;
+
+            continue;
+        }
+
+        if (granted[s] > 1)
+            _segmentsReplayed++;
+
+        _lastVisited[s] = pass;
+
+        int first = s * _segmentLength;
+        int last = std::min(_numFrames, first + _segmentLength);
+
+        for (int r = 0; r < granted[s]; r++)
+            for (int f = first; f < last; f++)
+                _schedule.push_back(f);
+    }
+
+    return static_cast<int>(_schedule.size());
+}
+
+bool PlateauDetector::update(float error) {
+    _history.push_back(error);
+
+    if (static_cast<int>(_history.size()) < _window * 2)
+        return false;
+
+    std::vector<float>::const_iterator split = _history.end() - _window;
+
+    float previous = std::accumulate(split - _window, split, 0.0f) / _window;
+    float current = std::accumulate(split, _history.cend(), 0.0f) / _window;
+
+    return previous <= 0.0f || (previous - current) / previous < _minImprovement;
+}
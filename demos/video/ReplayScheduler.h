@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+
+namespace video {
+    // Plans training passes over cached frames from their last measured prediction errors.
+    // Frames are grouped into fixed length segments (short runs keep the sequence the hierarchy
+    // learns intact). Segments well below the mean error are skipped, except for a periodic
+    // revisit so forgetting is noticed, and the rest are replayed back to back in proportion
+    // to their error. A pass never schedules more frames than a uniform sweep
+    class ReplayScheduler {
+    private:
+        int _numFrames;
+        int _segmentLength;
+
+        // Segments with error below this fraction of the mean are skipped
+        float _convergedRatio;
+
+        int _maxReplays;
+
+        // Passes a converged segment may go unvisited
+        int _revisitPasses;
+
+        // Pass each segment was last trained on
+        std::vector<int> _lastVisited;
+
+        // Frames of the planned pass in feed order
+        std::vector<int> _schedule;
+
+        int _segmentsSkipped;
+        int _segmentsReplayed;
+
+    public:
+        ReplayScheduler()
+            : _numFrames(0), _segmentLength(1), _convergedRatio(0.5f), _maxReplays(4), _revisitPasses(4),
+            _segmentsSkipped(0), _segmentsReplayed(0)
+        {}
+
+        void create(int numFrames, int segmentLength = 32, float convergedRatio = 0.5f, int maxReplays = 4, int revisitPasses = 4);
+
+        // Plan a pass from the error of each frame (numFrames entries), returns the frames scheduled
+        int plan(const std::vector<float> &frameErrors, int pass);
+
+        const std::vector<int> &getSchedule() const {
+            return _schedule;
+        }
+
+        int getNumSegments() const {
+            return static_cast<int>(_lastVisited.size());
+        }
+
+        // Segments left out of, and trained more than once in, the last planned pass
+        int getSegmentsSkipped() const {
+            return _segmentsSkipped;
+        }
+
+        int getSegmentsReplayed() const {
+            return _segmentsReplayed;
+        }
+    };
+
+    // Detects when a per pass error stops improving: the mean of the last window passes
+    // improved on the mean of the window before by less than minImprovement (relative)
+    class PlateauDetector {
+    private:
+        int _window;
+        float _minImprovement;
+
+        std::vector<float> _history;
+
+    public:
+        PlateauDetector()
+            : _window(2), _minImprovement(0.01f)
+        {}
+
+        void create(int window = 2, float minImprovement = 0.01f) {
+            _window = window;
+            _minImprovement = minImprovement;
+
+            _history.clear();
+        }
+
+        // Add a pass error, returns whether training has plateaued
+        bool update(float error);
+    };
+}
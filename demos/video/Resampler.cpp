@@ -0,0 +1,310 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "Resampler.h"
+
+#include <util/Simd.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace video;
+
+namespace {
+    // acc[i] += weight * row[i]. Multiplies and adds are kept separate (no FMA, and the file is built
+    // without contraction) so that every instruction set produces the same bytes as the scalar code
+    void accumulateRow(float* acc, const float* row, float weight, int count) {
+        int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+        __m256 w = _mm256_set1_ps(weight);
+
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_mul_ps(w, _mm256_loadu_ps(row + i)), _mm256_loadu_ps(acc + i)));
+#elif defined(DEMOS_SIMD_NEON)
+        float32x4_t w = vdupq_n_f32(weight);
+
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(acc + i, vmlaq_f32(vld1q_f32(acc + i), w, vld1q_f32(row + i)));
+#endif
+
+        for (; i < count; i++)
+            acc[i] += weight * row[i];
+    }
+
+    // Round and saturate to [0, 255]
+    void storeBytes(const float* acc, unsigned char* dst, int count) {
+        int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        for (; i + 16 <= count; i += 16) {
+            // Add a half and truncate like the scalar and NEON paths, not the round to even of cvtps
+            __m256i lo = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_loadu_ps(acc + i), half));
+            __m256i hi = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_loadu_ps(acc + i + 8), half));
+
+            // Packs work per 128-bit lane, so restore element order afterwards
+            __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xd8);
+            __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+        }
+#elif defined(DEMOS_SIMD_NEON)
+        for (; i + 8 <= count; i += 8) {
+            int32x4_t lo = vcvtq_s32_f32(vaddq_f32(vld1q_f32(acc + i), vdupq_n_f32(0.5f)));
+            int32x4_t hi = vcvtq_s32_f32(vaddq_f32(vld1q_f32(acc + i + 4), vdupq_n_f32(0.5f)));
+
+            vst1_u8(dst + i, vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+        }
+#endif
+
+        for (; i < count; i++)
+            dst[i] = static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, acc[i] + 0.5f)));
+    }
+
+    // Scale and clamp to [0, 1]
+    void storeFloats(const float* acc, float* dst, float scale, int count) {
+        int i = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+        __m256 s = _mm256_set1_ps(scale);
+        __m256 zero = _mm256_setzero_ps();
+        __m256 one = _mm256_set1_ps(1.0f);
+
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_mul_ps(s, _mm256_loadu_ps(acc + i)))));
+#elif defined(DEMOS_SIMD_NEON)
+        float32x4_t zero = vdupq_n_f32(0.0f);
+        float32x4_t one = vdupq_n_f32(1.0f);
+
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vminq_f32(one, vmaxq_f32(zero, vmulq_n_f32(vld1q_f32(acc + i), scale))));
+#endif
+
+        for (; i < count; i++)
+            dst[i] = std::min(1.0f, std::max(0.0f, acc[i] * scale));
+    }
+}
+
+void Resampler::computeTaps(int srcSize, int dstSize, float scale, Filter filter, Taps &taps) {
+    taps._first.assign(dstSize, 0);
+    taps._count.assign(dstSize, 0);
+
+    std::vector<std::vector<float>> weights(dstSize);
+
+    // Offset of the scaled source inside the destination (centering)
+    float offset = 0.5f * (dstSize - srcSize * scale);
+
+    for (int x = 0; x < dstSize; x++) {
+        if (filter == _area) {
+            // Source interval covered by this destination pixel
+            float a = std::max(0.0f, (x - offset) / scale);
+            float b = std::min(static_cast<float>(srcSize), (x + 1 - offset) / scale);
+
+            if (b <= a)
+                continue;
+
+            int first = static_cast<int>(std::floor(a));
+            int last = std::min(srcSize - 1, static_cast<int>(std::ceil(b)) - 1);
+
+            taps._first[x] = first;
+
+            for (int i = first; i <= last; i++)
+                weights[x].push_back((std::min(i + 1.0f, b) - std::max(static_cast<float>(i), a)) * scale);
+        }
+        else {
+            float center = (x + 0.5f - offset) / scale;
+
+            if (center < 0.0f || center >= srcSize)
+                continue;
+
+            float u = center - 0.5f;
+
+            int i0 = static_cast<int>(std::floor(u));
+
+            float f = u - i0;
+
+            if (i0 < 0) {
+                taps._first[x] = 0;
+                weights[x].push_back(1.0f);
+            }
+            else if (i0 >= srcSize - 1) {
+                taps._first[x] = srcSize - 1;
+                weights[x].push_back(1.0f);
+            }
+            else {
+                taps._first[x] = i0;
+                weights[x].push_back(1.0f - f);
+                weights[x].push_back(f);
+            }
+        }
+    }
+
+    taps._maxTaps = 1;
+
+    for (int x = 0; x < dstSize; x++)
+        taps._maxTaps = std::max(taps._maxTaps, static_cast<int>(weights[x].size()));
+
+    taps._weights.assign(dstSize * taps._maxTaps, 0.0f);
+
+    for (int x = 0; x < dstSize; x++) {
+        taps._count[x] = static_cast<int>(weights[x].size());
+
+        std::copy(weights[x].begin(), weights[x].end(), taps._weights.begin() + x * taps._maxTaps);
+    }
+}
+
+void Resampler::create(int srcWidth, int srcHeight, int dstWidth, int dstHeight, Filter filter, float videoScale) {
+    _srcWidth = srcWidth;
+    _srcHeight = srcHeight;
+    _dstWidth = dstWidth;
+    _dstHeight = dstHeight;
+
+    float scale = videoScale * std::min(static_cast<float>(dstWidth) / srcWidth, static_cast<float>(dstHeight) / srcHeight);
+
+    computeTaps(srcWidth, dstWidth, scale, filter, _xTaps);
+    computeTaps(srcHeight, dstHeight, scale, filter, _yTaps);
+
+    // Range of source rows that contribute to the output
+    _firstRow = srcHeight;
+    _lastRow = -1;
+
+    for (int y = 0; y < dstHeight; y++)
+        if (_yTaps._count[y] > 0) {
+            _firstRow = std::min(_firstRow, _yTaps._first[y]);
+            _lastRow = std::max(_lastRow, _yTaps._first[y] + _yTaps._count[y] - 1);
+        }
+
+    // Transposed horizontal taps. Unused taps point at the pixel's first tap so every gather is in range
+    const int blockSize = 8;
+
+    _xOffsets.assign(_xTaps._maxTaps * dstWidth, 0);
+    _xWeights.assign(_xTaps._maxTaps * dstWidth, 0.0f);
+    _xBlockGather.assign((dstWidth + blockSize - 1) / blockSize, 1);
+
+    for (int x = 0; x < dstWidth; x++)
+        for (int k = 0; k < _xTaps._maxTaps; k++) {
+            int offset = 3 * (_xTaps._first[x] + (k < _xTaps._count[x] ? k : 0));
+
+            _xOffsets[k * dstWidth + x] = offset;
+            _xWeights[k * dstWidth + x] = k < _xTaps._count[x] ? _xTaps._weights[x * _xTaps._maxTaps + k] : 0.0f;
+
+            // A gather reads one byte past the pixel, which is past the row for the last source pixel
+            if (offset + 4 > 3 * srcWidth)
+                _xBlockGather[x / blockSize] = 0;
+        }
+
+    _rows.assign(std::max(0, _lastRow - _firstRow + 1) * 3 * dstWidth, 0.0f);
+    _accum.assign(3 * dstWidth, 0.0f);
+}
+
+void Resampler::filterPixels(const unsigned char* src, float* rowR, float* rowG, float* rowB, int begin, int end) const {
+    for (int x = begin; x < end; x++) {
+        const float* weights = &_xTaps._weights[x * _xTaps._maxTaps];
+        const unsigned char* pixel = src + 3 * _xTaps._first[x];
+
+        float r = 0.0f, g = 0.0f, b = 0.0f;
+
+        for (int k = 0; k < _xTaps._count[x]; k++, pixel += 3) {
+            b += weights[k] * pixel[0];
+            g += weights[k] * pixel[1];
+            r += weights[k] * pixel[2];
+        }
+
+        rowR[x] = r;
+        rowG[x] = g;
+        rowB[x] = b;
+    }
+}
+
+void Resampler::filterRows(const unsigned char* bgr, size_t rowStride) {
+    const int rowSize = 3 * _dstWidth;
+
+    for (int sy = _firstRow; sy <= _lastRow; sy++) {
+        const unsigned char* src = bgr + rowStride * sy;
+
+        float* rowR = &_rows[(sy - _firstRow) * rowSize];
+        float* rowG = rowR + _dstWidth;
+        float* rowB = rowG + _dstWidth;
+
+        int x = 0;
+
+#if defined(DEMOS_SIMD_AVX2)
+        // Each tap gathers one BGR pixel (plus a spare byte) per destination pixel as a 32-bit lane
+        const __m256i byteMask = _mm256_set1_epi32(0xff);
+
+        for (; x + 8 <= _dstWidth; x += 8) {
+            if (!_xBlockGather[x / 8]) {
+                filterPixels(src, rowR, rowG, rowB, x, x + 8);
+                continue;
+            }
+
+            __m256 r = _mm256_setzero_ps();
+            __m256 g = _mm256_setzero_ps();
+            __m256 b = _mm256_setzero_ps();
+
+            for (int k = 0; k < _xTaps._maxTaps; k++) {
+                __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&_xOffsets[k * _dstWidth + x]));
+                __m256 w = _mm256_loadu_ps(&_xWeights[k * _dstWidth + x]);
+
+                __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), offsets, 1);
+
+                b = _mm256_add_ps(b, _mm256_mul_ps(w, _mm256_cvtepi32_ps(_mm256_and_si256(pixels, byteMask))));
+                g = _mm256_add_ps(g, _mm256_mul_ps(w, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), byteMask))));
+                r = _mm256_add_ps(r, _mm256_mul_ps(w, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), byteMask))));
+            }
+
+            _mm256_storeu_ps(rowR + x, r);
+            _mm256_storeu_ps(rowG + x, g);
+            _mm256_storeu_ps(rowB + x, b);
+        }
+#endif
+
+        filterPixels(src, rowR, rowG, rowB, x, _dstWidth);
+    }
+}
+
+void Resampler::filterColumn(int y) {
+    const int rowSize = 3 * _dstWidth;
+
+    std::fill(_accum.begin(), _accum.end(), 0.0f);
+
+    const float* weights = &_yTaps._weights[y * _yTaps._maxTaps];
+
+    for (int k = 0; k < _yTaps._count[y]; k++)
+        accumulateRow(_accum.data(), &_rows[(_yTaps._first[y] + k - _firstRow) * rowSize], weights[k], rowSize);
+}
+
+void Resampler::resample(const unsigned char* bgr, size_t rowStride, unsigned char* planes) {
+    const int planeSize = _dstWidth * _dstHeight;
+
+    filterRows(bgr, rowStride);
+
+    for (int y = 0; y < _dstHeight; y++) {
+        filterColumn(y);
+
+        for (int c = 0; c < 3; c++)
+            storeBytes(&_accum[c * _dstWidth], planes + c * planeSize + y * _dstWidth, _dstWidth);
+    }
+}
+
+void Resampler::resample(const unsigned char* bgr, size_t rowStride, float* r, float* g, float* b) {
+    const float byteInv = 1.0f / 255.0f;
+
+    float* planes[3] = { r, g, b };
+
+    filterRows(bgr, rowStride);
+
+    for (int y = 0; y < _dstHeight; y++) {
+        filterColumn(y);
+
+        for (int c = 0; c < 3; c++)
+            storeFloats(&_accum[c * _dstWidth], planes[c] + y * _dstWidth, byteInv, _dstWidth);
+    }
+}
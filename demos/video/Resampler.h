@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace video {
+    // Separable CPU resampler from interleaved 8-bit BGR (OpenCV layout) to planar RGB.
+    // The source is scaled uniformly to fit the destination, centered, with black borders,
+    // matching the previous render target rescale. Needs no GL context
+    class Resampler {
+    public:
+        enum Filter {
+            // Box filter weighted by pixel coverage, best for downscaling
+            _area,
+
+            // Two tap linear interpolation per axis
+            _bilinear
+        };
+
+    private:
+        // Filter taps along one axis
+        struct Taps {
+            std::vector<int> _first;
+            std::vector<int> _count;
+            std::vector<float> _weights;
+
+            int _maxTaps;
+        };
+
+        int _srcWidth, _srcHeight;
+        int _dstWidth, _dstHeight;
+
+        Taps _xTaps;
+        Taps _yTaps;
+
+        // Horizontal taps by tap then destination pixel, as byte offsets into a source row and
+        // weights (zero past a pixel's tap count), so eight destination pixels are gathered at once
+        std::vector<int> _xOffsets;
+        std::vector<float> _xWeights;
+
+        // Per block of eight destination pixels, whether 4 byte gathers stay inside the row
+        std::vector<unsigned char> _xBlockGather;
+
+        // Horizontally filtered source rows, each 3 * dstWidth floats (R, G, B planes)
+        std::vector<float> _rows;
+
+        // Vertical accumulation buffer for one destination row
+        std::vector<float> _accum;
+
+        int _firstRow, _lastRow;
+
+        static void computeTaps(int srcSize, int dstSize, float scale, Filter filter, Taps &taps);
+
+        void filterPixels(const unsigned char* src, float* rowR, float* rowG, float* rowB, int begin, int end) const;
+        void filterRows(const unsigned char* bgr, size_t rowStride);
+        void filterColumn(int y);
+
+    public:
+        Resampler()
+            : _srcWidth(0), _srcHeight(0), _dstWidth(0), _dstHeight(0), _firstRow(0), _lastRow(-1)
+        {}
+
+        // Precompute filter tables. videoScale further scales the fitted source (1 = fit exactly)
+        void create(int srcWidth, int srcHeight, int dstWidth, int dstHeight, Filter filter = _area, float videoScale = 1.0f);
+
+        int getSrcWidth() const {
+            return _srcWidth;
+        }
+
+        int getSrcHeight() const {
+            return _srcHeight;
+        }
+
+        int getDstWidth() const {
+            return _dstWidth;
+        }
+
+        int getDstHeight() const {
+            return _dstHeight;
+        }
+
+        // Resample to planar 8-bit RGB, R plane first (3 * dstWidth * dstHeight bytes)
+        void resample(const unsigned char* bgr, size_t rowStride, unsigned char* planes);
+
+        // Resample to planar float RGB in [0, 1]
+        void resample(const unsigned char* bgr, size_t rowStride, float* r, float* g, float* b);
+    };
+}
@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "RolloutEvaluator.h"
+#include "FrameQuality.h"
+#include "PixelKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+using namespace video;
+
+void RolloutEvaluator::create(int seedFrames, int horizon, int numThreads) {
+    _seedFrames = std::max(1, seedFrames);
+    _horizon = std::max(1, horizon);
+
+    _pool.create(numThreads);
+}
+
+bool RolloutEvaluator::evaluate(FramePredictor &predictor, const FrameCache &cache, int numStarts) {
+    const int width = cache.getWidth();
+    const int height = cache.getHeight();
+    const int planeSize = width * height;
+
+    // Last start frame that leaves room for the seed and the full horizon
+    int lastStart = cache.getNumFrames() - _seedFrames - _horizon;
+
+    if (lastStart < 0 || numStarts < 1)
+        return false;
+
+    _numStarts = std::min(numStarts, lastStart + 1);
+
+    _psnr.assign(_numStarts * _horizon, 0.0f);
+    _ssim.assign(_numStarts * _horizon, 0.0f);
+
+    for (int set = 0; set < 2; set++)
+        _predictions[set].assign(_horizon, std::vector<float>(planeSize * 3));
+
+    for (int s = 0; s < _numStarts; s++) {
+        int start = _numStarts > 1 ? static_cast<int>(static_cast<long long>(lastStart) * s / (_numStarts - 1)) : 0;
+
+        std::vector<std::vector<float>> &predictions = _predictions[s % 2];
+
+        // Seed with real frames, the last activation predicts the first unseen frame
+        for (int k = 0; k < _seedFrames; k++) {
+            encodeFramePlanar(cache.getFrame(start + k), planeSize,
+                predictor.getPredictionData(0), predictor.getPredictionData(1), predictor.getPredictionData(2),
+                predictor.getInputData(0), predictor.getInputData(1), predictor.getInputData(2), 0.0f);
+
+            predictor.activate();
+        }
+
+        // Roll out on the hierarchy's own predictions
+        for (int h = 0; h < _horizon; h++) {
+            if (h > 0) {
+                predictor.feedBackPredictions();
+                predictor.activate();
+            }
+
+            for (int c = 0; c < 3; c++)
+                std::memcpy(predictions[h].data() + planeSize * c, predictor.getPredictionData(c), planeSize * sizeof(float));
+        }
+
+        // Scoring of the previous start overlapped with this rollout, its buffers are free once it is done
+        _pool.wait();
+
+        for (int h = 0; h < _horizon; h++) {
+            const float* prediction = predictions[h].data();
+            const unsigned char* truth = cache.getFrame(start + _seedFrames + h);
+            int index = h + s * _horizon;
+
+            _pool.push([this, prediction, truth, index, width, height, planeSize]() {
+                _psnr[index] = computePSNR(prediction, prediction + planeSize, prediction + planeSize * 2, truth, width, height);
+                _ssim[index] = computeSSIM(prediction, prediction + planeSize, prediction + planeSize * 2, truth, width, height);
+            });
+        }
+    }
+
+    _pool.wait();
+
+    _results.assign(_horizon, HorizonQuality());
+
+    for (int h = 0; h < _horizon; h++) {
+        double psnrSum = 0.0, psnrSquareSum = 0.0;
+        double ssimSum = 0.0, ssimSquareSum = 0.0;
+
+        for (int s = 0; s < _numStarts; s++) {
+            float psnr = _psnr[h + s * _horizon];
+            float ssim = _ssim[h + s * _horizon];
+
+            psnrSum += psnr;
+            psnrSquareSum += psnr * psnr;
+            ssimSum += ssim;
+            ssimSquareSum += ssim * ssim;
+        }
+
+        HorizonQuality &quality = _results[h];
+
+        quality._psnrMean = static_cast<float>(psnrSum / _numStarts);
+        quality._psnrStdDev = static_cast<float>(std::sqrt(std::max(0.0, psnrSquareSum / _numStarts - quality._psnrMean * quality._psnrMean)));
+        quality._ssimMean = static_cast<float>(ssimSum / _numStarts);
+        quality._ssimStdDev = static_cast<float>(std::sqrt(std::max(0.0, ssimSquareSum / _numStarts - quality._ssimMean * quality._ssimMean)));
+    }
+
+    return true;
+}
+
+void RolloutEvaluator::writeTable(std::ostream &os, bool csv) const {
+    if (csv) {
+        os << "horizon,psnr_mean,psnr_stddev,ssim_mean,ssim_stddev" << std::endl;
+
+        for (int h = 0; h < static_cast<int>(_results.size()); h++)
+            os << (h + 1) << "," << _results[h]._psnrMean << "," << _results[h]._psnrStdDev << "," <<
+                _results[h]._ssimMean << "," << _results[h]._ssimStdDev << std::endl;
+
+        return;
+    }
+
+    os << std::setw(8) << "Horizon" << std::setw(20) << "PSNR (dB)" << std::setw(20) << "SSIM" << std::endl;
+
+    for (int h = 0; h < static_cast<int>(_results.size()); h++)
+        os << std::setw(8) << (h + 1) << std::fixed
+            << std::setw(12) << std::setprecision(2) << _results[h]._psnrMean << " +- " << std::setw(4) << _results[h]._psnrStdDev
+            << std::setw(12) << std::setprecision(4) << _results[h]._ssimMean << " +- " << std::setw(6) << _results[h]._ssimStdDev << std::endl;
+}
@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/ThreadPool.h>
+
+#include "FrameCache.h"
+#include "FramePredictor.h"
+
+#include <ostream>
+#include <vector>
+
+namespace video {
+    // Quality of predictions a given number of steps past the last real frame
+    struct HorizonQuality {
+        float _psnrMean;
+        float _psnrStdDev;
+        float _ssimMean;
+        float _ssimStdDev;
+
+        HorizonQuality()
+            : _psnrMean(0.0f), _psnrStdDev(0.0f), _ssimMean(0.0f), _ssimStdDev(0.0f)
+        {}
+    };
+
+    // Multi-step prediction quality of a trained hierarchy. From each start frame the hierarchy is
+    // seeded with real frames, then rolled out on its own predictions, and every predicted frame is
+    // scored against the true frame. Scoring runs on a thread pool while the hierarchy produces the
+    // next rollout
+    class RolloutEvaluator {
+    private:
+        int _seedFrames;
+        int _horizon;
+
+        util::ThreadPool _pool;
+
+        // Two sets of horizon predicted frames (planar float RGB), one being scored while the other is filled
+        std::vector<std::vector<float>> _predictions[2];
+
+        // Per start and horizon step
+        std::vector<float> _psnr;
+        std::vector<float> _ssim;
+
+        std::vector<HorizonQuality> _results;
+
+        int _numStarts;
+
+    public:
+        RolloutEvaluator()
+            : _seedFrames(0), _horizon(0), _numStarts(0)
+        {}
+
+        // Rollouts of horizon frames after seedFrames real frames, scored on numThreads threads
+        void create(int seedFrames, int horizon, int numThreads);
+
+        // Evaluate rollouts from numStarts start frames spread evenly over the cached frames.
+        // The predictor's frame size must match the cache
+        bool evaluate(FramePredictor &predictor, const FrameCache &cache, int numStarts);
+
+        // Quality per horizon step (index 0 is one step ahead)
+        const std::vector<HorizonQuality> &getResults() const {
+            return _results;
+        }
+
+        int getNumStarts() const {
+            return _numStarts;
+        }
+
+        // Horizon versus quality table, as aligned text or CSV
+        void writeTable(std::ostream &os, bool csv) const;
+    };
+}
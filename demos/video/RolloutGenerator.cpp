@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "RolloutGenerator.h"
+#include "PixelKernels.h"
+
+using namespace video;
+
+void RolloutGenerator::create(FramePredictor &predictor, int width, int height, int capacity) {
+    stop();
+
+    _predictor = &predictor;
+    _width = width;
+    _height = height;
+
+    RolloutFrame prototype;
+    prototype._pixels.resize(width * height * 4);
+
+    _queue.create(capacity, prototype);
+}
+
+void RolloutGenerator::start(int numFrames) {
+    stop();
+
+    _stop = false;
+    _finished = false;
+
+    _framesGenerated = 0;
+    _generatorStalls = 0;
+
+    _thread = std::thread(&RolloutGenerator::generate, this, numFrames);
+}
+
+void RolloutGenerator::generate(int numFrames) {
+    for (int step = 0; !_stop && (numFrames < 0 || step < numFrames); step++) {
+        RolloutFrame* frame = _queue.beginPush();
+
+        if (frame == nullptr) {
+            _generatorStalls++;
+
+            int spins = 0;
+
+            while (!_stop && (frame = _queue.beginPush()) == nullptr)
+                util::backOff(spins);
+
+            if (frame == nullptr)
+                break;
+        }
+
+        // Feed the predictor its own predictions
+        _predictor->feedBackPredictions();
+        _predictor->activate();
+
+        decodePredictionRGBA(_predictor->getPredictionData(0), _predictor->getPredictionData(1), _predictor->getPredictionData(2),
+            _width * _height, frame->_pixels.data());
+
+        frame->_step = step;
+
+        _queue.endPush();
+
+        _framesGenerated++;
+    }
+
+    _finished = true;
+}
+
+const RolloutFrame* RolloutGenerator::acquire(bool wait) {
+    RolloutFrame* frame = _queue.front();
+
+    if (frame == nullptr && wait) {
+        // Finished must be checked before the final look at the queue, frames pushed before it was set are still delivered
+        int spins = 0;
+
+        for (;;) {
+            bool finished = _finished;
+
+            frame = _queue.front();
+
+            if (frame != nullptr || finished)
+                break;
+
+            util::backOff(spins);
+        }
+    }
+
+    return frame;
+}
+
+void RolloutGenerator::release() {
+    _queue.pop();
+}
+
+void RolloutGenerator::stop() {
+    _stop = true;
+
+    if (_thread.joinable())
+        _thread.join();
+
+    while (_queue.front() != nullptr)
+        _queue.pop();
+}
@@ -0,0 +1,90 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/SpscQueue.h>
+
+#include "FramePredictor.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace video {
+    // A generated frame waiting to be displayed or written
+    struct RolloutFrame {
+        // Interleaved 8-bit RGBA, ready for sf::Texture::update
+        std::vector<unsigned char> _pixels;
+
+        // Steps since the rollout started
+        int _step;
+
+        RolloutFrame()
+            : _step(0)
+        {}
+    };
+
+    // Runs a predictor on its own predictions (one feedback + activate per frame) on a worker
+    // thread, converting each prediction to RGBA into a preallocated ring. The consumer only
+    // touches finished frames. While running, the worker is the only user of the predictor
+    class RolloutGenerator {
+    private:
+        util::SpscQueue<RolloutFrame> _queue;
+
+        FramePredictor* _predictor;
+
+        int _width, _height;
+
+        std::thread _thread;
+
+        std::atomic<bool> _stop;
+        std::atomic<bool> _finished;
+
+        std::atomic<uint64_t> _framesGenerated;
+        std::atomic<uint64_t> _generatorStalls;
+
+        void generate(int numFrames);
+
+    public:
+        RolloutGenerator()
+            : _predictor(nullptr), _width(0), _height(0), _stop(false), _finished(true),
+            _framesGenerated(0), _generatorStalls(0)
+        {}
+
+        ~RolloutGenerator() {
+            stop();
+        }
+
+        // Frames are generated by a predictor of width x height frames,
+        // up to capacity frames ahead of the consumer
+        void create(FramePredictor &predictor, int width, int height, int capacity);
+
+        // Generate numFrames frames, or until stopped if numFrames < 0
+        void start(int numFrames = -1);
+
+        // Oldest finished frame. Returns nullptr if none is ready (when not waiting) or the rollout has ended
+        const RolloutFrame* acquire(bool wait);
+
+        // Hand the frame returned by acquire back to the generator
+        void release();
+
+        // Stop the worker, discarding frames not yet consumed
+        void stop();
+
+        uint64_t getFramesGenerated() const {
+            return _framesGenerated;
+        }
+
+        // Times the worker found the ring full (the consumer is the bottleneck)
+        uint64_t getGeneratorStalls() const {
+            return _generatorStalls;
+        }
+    };
+}
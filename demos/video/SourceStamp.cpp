@@ -0,0 +1,34 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "SourceStamp.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+using namespace video;
+
+bool SourceStamp::fromFile(const std::string &fileName) {
+    struct stat fileStat;
+
+    if (stat(fileName.c_str(), &fileStat) != 0)
+        return false;
+
+    // FNV-1a hash of the path
+    _pathHash = 14695981039346656037ull;
+
+    for (char c : fileName) {
+        _pathHash ^= static_cast<unsigned char>(c);
+        _pathHash *= 1099511628211ull;
+    }
+
+    _size = static_cast<uint64_t>(fileStat.st_size);
+    _modifiedTime = static_cast<int64_t>(fileStat.st_mtime);
+
+    return true;
+}
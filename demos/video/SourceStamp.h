@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace video {
+    // Identifies a source video so derived files (caches, indices) can be invalidated when it changes
+    struct SourceStamp {
+        uint64_t _pathHash;
+        uint64_t _size;
+        int64_t _modifiedTime;
+
+        SourceStamp()
+            : _pathHash(0), _size(0), _modifiedTime(0)
+        {}
+
+        // Fill in the stamp from the file system, returns false if the file does not exist
+        bool fromFile(const std::string &fileName);
+
+        bool operator==(const SourceStamp &other) const {
+            return _pathHash == other._pathHash && _size == other._size && _modifiedTime == other._modifiedTime;
+        }
+
+        bool operator!=(const SourceStamp &other) const {
+            return !(*this == other);
+        }
+    };
+}
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "TiledHierarchy.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace video;
+
+namespace {
+    // Tile origins along one axis, evenly strided with the last tile aligned to the far edge
+    std::vector<int> tileOrigins(int size, int tileSize, int overlap) {
+        int stride = std::max(1, tileSize - overlap);
+
+        std::vector<int> origins;
+
+        for (int origin = 0; origin + tileSize < size; origin += stride)
+            origins.push_back(origin);
+
+        origins.push_back(std::max(0, size - tileSize));
+
+        return origins;
+    }
+
+    // Weight falling off linearly over the overlap, so neighbouring tiles cross fade
+    float edgeRamp(int i, int tileSize, int overlap) {
+        if (overlap <= 0)
+            return 1.0f;
+
+        return std::min(1.0f, std::min((i + 0.5f) / overlap, (tileSize - i - 0.5f) / overlap));
+    }
+}
+
+void TiledHierarchy::create(int width, int height, int tileSize, int overlap, const LayerSetup &layerSetup,
+    ogmaneo::ComputeSystem::DeviceType deviceType, unsigned int seed, int numWorkers)
+{
+    _width = width;
+    _height = height;
+    _tileSize = std::min(tileSize, std::min(width, height));
+
+    overlap = std::max(0, std::min(overlap, _tileSize - 1));
+
+    _tiles.clear();
+    _workers.clear();
+
+    std::vector<int> originsX = tileOrigins(_width, _tileSize, overlap);
+    std::vector<int> originsY = tileOrigins(_height, _tileSize, overlap);
+
+    const int numTiles = static_cast<int>(originsX.size() * originsY.size());
+
+    _workers.resize(std::max(1, std::min(numWorkers, numTiles)));
+
+    for (Worker &worker : _workers) {
+        worker._resources = std::make_shared<ogmaneo::Resources>();
+        worker._resources->create(deviceType);
+    }
+
+    for (int y : originsY)
+        for (int x : originsX) {
+            std::unique_ptr<Tile> tile(new Tile());
+
+            tile->_x = x;
+            tile->_y = y;
+
+            Worker &worker = _workers[_tiles.size() % _workers.size()];
+
+            tile->_resources = worker._resources;
+
+            worker._tiles.push_back(tile.get());
+
+            ogmaneo::Architect arch;
+            arch.initialize(seed + static_cast<unsigned int>(_tiles.size()), tile->_resources);
+
+            layerSetup(arch, _tileSize);
+
+            tile->_hierarchy = arch.generateHierarchy();
+
+            ogmaneo::Vec2i inputSize(_tileSize, _tileSize);
+
+            tile->_staging.create(tile->_hierarchy, { inputSize, inputSize, inputSize });
+
+            _tiles.push_back(std::move(tile));
+        }
+
+    _tileWeights.resize(_tileSize * _tileSize);
+
+    for (int ty = 0; ty < _tileSize; ty++)
+        for (int tx = 0; tx < _tileSize; tx++)
+            _tileWeights[tx + ty * _tileSize] = edgeRamp(tx, _tileSize, overlap) * edgeRamp(ty, _tileSize, overlap);
+
+    _weightNormalization.assign(_width * _height, 0.0f);
+
+    for (const std::unique_ptr<Tile> &tile : _tiles)
+        for (int ty = 0; ty < _tileSize; ty++)
+            for (int tx = 0; tx < _tileSize; tx++)
+                _weightNormalization[(tile->_x + tx) + (tile->_y + ty) * _width] += _tileWeights[tx + ty * _tileSize];
+
+    for (float &w : _weightNormalization)
+        w = 1.0f / w;
+
+    _inputs.assign(_width * _height * 3, 0.0f);
+    _predictions.assign(_width * _height * 3, 0.0f);
+
+    _pool.create(getNumWorkers());
+
+    _stitchBandHeight = (_height + getNumWorkers() - 1) / getNumWorkers();
+}
+
+void TiledHierarchy::activate() {
+    const int planeSize = _width * _height;
+
+    for (const Worker &worker : _workers) {
+        const Worker* w = &worker;
+
+        // A worker's tiles share its queue, so they run in turn on one thread
+        _pool.push([this, w, planeSize]() {
+            for (Tile* tile : w->_tiles) {
+                for (int c = 0; c < 3; c++) {
+                    const float* src = _inputs.data() + c * planeSize + tile->_x + tile->_y * _width;
+                    float* dst = tile->_staging.getInputData(c);
+
+                    for (int ty = 0; ty < _tileSize; ty++)
+                        std::memcpy(dst + ty * _tileSize, src + ty * _width, _tileSize * sizeof(float));
+                }
+
+                tile->_staging.activate();
+            }
+        });
+    }
+
+    _pool.wait();
+
+    stitch();
+}
+
+void TiledHierarchy::stitch() {
+    const int planeSize = _width * _height;
+
+    // Horizontal bands of the frame in parallel, each gathering from the tiles that cover it
+    for (int bandStart = 0; bandStart < _height; bandStart += _stitchBandHeight) {
+        int bandEnd = std::min(_height, bandStart + _stitchBandHeight);
+
+        _pool.push([this, bandStart, bandEnd, planeSize]() {
+            for (int c = 0; c < 3; c++)
+                std::fill(_predictions.begin() + c * planeSize + bandStart * _width, _predictions.begin() + c * planeSize + bandEnd * _width, 0.0f);
+
+            for (const std::unique_ptr<Tile> &tile : _tiles) {
+                int rowStart = std::max(bandStart, tile->_y);
+                int rowEnd = std::min(bandEnd, tile->_y + _tileSize);
+
+                for (int c = 0; c < 3; c++) {
+                    const float* tilePrediction = tile->_staging.getPredictionData(c);
+                    float* framePrediction = _predictions.data() + c * planeSize;
+
+                    for (int y = rowStart; y < rowEnd; y++) {
+                        int ty = y - tile->_y;
+
+                        const float* src = tilePrediction + ty * _tileSize;
+                        const float* weights = _tileWeights.data() + ty * _tileSize;
+                        float* dst = framePrediction + tile->_x + y * _width;
+
+                        for (int tx = 0; tx < _tileSize; tx++)
+                            dst[tx] += weights[tx] * src[tx];
+                    }
+                }
+            }
+
+            for (int c = 0; c < 3; c++) {
+                float* framePrediction = _predictions.data() + c * planeSize;
+
+                for (int i = bandStart * _width; i < bandEnd * _width; i++)
+                    framePrediction[i] *= _weightNormalization[i];
+            }
+        });
+    }
+
+    _pool.wait();
+}
+
+void TiledHierarchy::learn() {
+    for (const Worker &worker : _workers) {
+        const Worker* w = &worker;
+
+        _pool.push([w]() {
+            for (Tile* tile : w->_tiles)
+                tile->_staging.learn();
+        });
+    }
+
+    _pool.wait();
+}
+
+void TiledHierarchy::feedBackPredictions() {
+    std::copy(_predictions.begin(), _predictions.end(), _inputs.begin());
+}
+
+void TiledHierarchy::save(const std::string &fileName) {
+    for (int i = 0; i < getNumTiles(); i++)
+        _tiles[i]->_hierarchy->save(*_tiles[i]->_resources->getComputeSystem(), fileName + ".tile" + std::to_string(i));
+}
+
+void TiledHierarchy::load(const std::string &fileName) {
+    for (int i = 0; i < getNumTiles(); i++)
+        _tiles[i]->_hierarchy->load(*_tiles[i]->_resources->getComputeSystem(), fileName + ".tile" + std::to_string(i));
+}
@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <neo/Architect.h>
+#include <neo/Hierarchy.h>
+
+#include <util/InputStaging.h>
+#include <util/ThreadPool.h>
+
+#include "FramePredictor.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace video {
+    // Frames larger than one hierarchy can handle, split into overlapping square tiles. Every tile
+    // has its own hierarchy built from the same layer configuration. Tiles are split over workers,
+    // each with one Resources (OpenCL context, queue and kernels built once) shared by its tiles, and
+    // the workers run concurrently on a thread pool. Tile predictions are stitched into the frame
+    // prediction with weights that ramp down across the overlap
+    class TiledHierarchy : public FramePredictor {
+    public:
+        // Adds the input and higher layers of one tile hierarchy for a tile of tileSize x tileSize
+        typedef std::function<void(ogmaneo::Architect &arch, int tileSize)> LayerSetup;
+
+    private:
+        struct Tile {
+            // Top left corner in the frame
+            int _x, _y;
+
+            // Of the tile's worker
+            std::shared_ptr<ogmaneo::Resources> _resources;
+
+            std::shared_ptr<ogmaneo::Hierarchy> _hierarchy;
+
+            util::InputStaging _staging;
+        };
+
+        struct Worker {
+            std::shared_ptr<ogmaneo::Resources> _resources;
+
+            std::vector<Tile*> _tiles;
+        };
+
+        std::vector<std::unique_ptr<Tile>> _tiles;
+        std::vector<Worker> _workers;
+
+        int _width, _height;
+        int _tileSize;
+
+        // Blend weight of each tile pixel, and one over the summed weights of each frame pixel
+        std::vector<float> _tileWeights;
+        std::vector<float> _weightNormalization;
+
+        // Planar frame inputs and stitched predictions
+        std::vector<float> _inputs;
+        std::vector<float> _predictions;
+
+        util::ThreadPool _pool;
+
+        // Rows of the frame stitched by each pool task
+        int _stitchBandHeight;
+
+        void stitch();
+
+    public:
+        TiledHierarchy()
+            : _width(0), _height(0), _tileSize(0), _stitchBandHeight(0)
+        {}
+
+        // Tile a width x height frame. Tiles of tileSize overlap by at least overlap pixels
+        // (the last row and column are aligned to the frame edge). One context is created per worker,
+        // at most numWorkers and never more than the number of tiles
+        void create(int width, int height, int tileSize, int overlap, const LayerSetup &layerSetup,
+            ogmaneo::ComputeSystem::DeviceType deviceType, unsigned int seed, int numWorkers);
+
+        int getNumTiles() const {
+            return static_cast<int>(_tiles.size());
+        }
+
+        int getNumWorkers() const {
+            return static_cast<int>(_workers.size());
+        }
+
+        float* getInputData(int channel) override {
+            return _inputs.data() + channel * _width * _height;
+        }
+
+        const float* getPredictionData(int channel) const override {
+            return _predictions.data() + channel * _width * _height;
+        }
+
+        void activate() override;
+
+        void learn() override;
+
+        void feedBackPredictions() override;
+
+        // Save or load every tile hierarchy, as fileName.tile<index>
+        void save(const std::string &fileName);
+        void load(const std::string &fileName);
+    };
+}
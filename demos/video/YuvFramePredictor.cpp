@@ -0,0 +1,44 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "YuvFramePredictor.h"
+#include "PixelKernels.h"
+
+#include <algorithm>
+
+using namespace video;
+
+void YuvFramePredictor::create(util::InputStaging &staging, int width, int height) {
+    _staging = &staging;
+    _width = width;
+    _height = height;
+
+    _inputs.assign(_width * _height * 3, 0.0f);
+    _predictions.assign(_width * _height * 3, 0.0f);
+}
+
+void YuvFramePredictor::activate() {
+    const int planeSize = _width * _height;
+
+    convertRGBToYUV420(_inputs.data(), _inputs.data() + planeSize, _inputs.data() + planeSize * 2, _width, _height,
+        _staging->getInputData(0), _staging->getInputData(1), _staging->getInputData(2));
+
+    _staging->activate();
+
+    convertYUV420ToRGB(_staging->getPredictionData(0), _staging->getPredictionData(1), _staging->getPredictionData(2), _width, _height,
+        _predictions.data(), _predictions.data() + planeSize, _predictions.data() + planeSize * 2);
+}
+
+void YuvFramePredictor::learn() {
+    _staging->learn();
+}
+
+void YuvFramePredictor::feedBackPredictions() {
+    // Subsampling nearest upsampled chroma is exact, so the hierarchy sees its own predictions again
+    std::copy(_predictions.begin(), _predictions.end(), _inputs.begin());
+}
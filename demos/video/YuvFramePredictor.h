@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <util/InputStaging.h>
+
+#include "FramePredictor.h"
+
+#include <vector>
+
+namespace video {
+    // A single hierarchy fed luma and chroma instead of RGB: a full resolution Y input layer and
+    // U and V input layers at half resolution in each dimension, half the input of three RGB layers.
+    // Frames are converted on the way in, and predictions back to RGB after each activation
+    class YuvFramePredictor : public FramePredictor {
+    private:
+        util::InputStaging* _staging;
+
+        int _width, _height;
+
+        // Planar RGB inputs and converted predictions
+        std::vector<float> _inputs;
+        std::vector<float> _predictions;
+
+    public:
+        YuvFramePredictor()
+            : _staging(nullptr), _width(0), _height(0)
+        {}
+
+        // Chroma layer size for a frame dimension
+        static int getChromaSize(int size) {
+            return (size + 1) / 2;
+        }
+
+        // Staging inputs must be Y (width x height), U and V (chroma sized)
+        void create(util::InputStaging &staging, int width, int height);
+
+        float* getInputData(int channel) override {
+            return _inputs.data() + channel * _width * _height;
+        }
+
+        const float* getPredictionData(int channel) const override {
+            return _predictions.data() + channel * _width * _height;
+        }
+
+        void activate() override;
+
+        void learn() override;
+
+        void feedBackPredictions() override;
+    };
+}
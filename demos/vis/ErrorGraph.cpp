@@ -0,0 +1,150 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#include "ErrorGraph.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vis;
+
+void ErrorGraph::create(int numFrames, const sf::Vector2f &origin, float maxWidth, float scaleX, float scaleY, int numGridLines, float gridSpacing) {
+    _numFrames = std::max(1, numFrames);
+    _origin = origin;
+    _scaleY = scaleY;
+    _numGridLines = numGridLines;
+    _gridSpacing = gridSpacing;
+
+    // Decimate to one column per pixel if the bars do not fit
+    if (_numFrames * scaleX <= maxWidth) {
+        _numColumns = _numFrames;
+        _columnWidth = scaleX;
+    }
+    else {
+        _numColumns = std::max(1, static_cast<int>(maxWidth));
+        _columnWidth = 1.0f;
+    }
+
+    _errors.assign(_numFrames, 0.0f);
+    _hasError.assign(_numFrames, false);
+
+    _dirty.assign(_numColumns, false);
+    _dirtyColumns.clear();
+
+    _currentColumn = -1;
+    _errorTotal = 0.0;
+    _errorCount = 0;
+
+    _vertices.setPrimitiveType(sf::Quads);
+    _vertices.resize((_numGridLines + 1 + _numColumns * 2) * 4);
+
+    // Horizontal grid lines
+    for (int i = 0; i < _numGridLines; i++)
+        setQuad(i, _origin.x, _origin.y - _gridSpacing * i, getWidth(), 1.0f, _gridColor);
+
+    for (int c = 0; c < _numColumns; c++)
+        markDirty(c);
+}
+
+void ErrorGraph::setQuad(int quad, float left, float top, float width, float height, const sf::Color &color) {
+    sf::Vertex* v = &_vertices[quad * 4];
+
+    v[0].position = sf::Vector2f(left, top);
+    v[1].position = sf::Vector2f(left + width, top);
+    v[2].position = sf::Vector2f(left + width, top + height);
+    v[3].position = sf::Vector2f(left, top + height);
+
+    for (int i = 0; i < 4; i++)
+        v[i].color = color;
+}
+
+void ErrorGraph::markDirty(int column) {
+    if (!_dirty[column]) {
+        _dirty[column] = true;
+        _dirtyColumns.push_back(column);
+    }
+}
+
+int ErrorGraph::getColumn(int frame) const {
+    return static_cast<int>(static_cast<long long>(frame) * _numColumns / _numFrames);
+}
+
+void ErrorGraph::rebuildColumn(int column) {
+    int first = getFirstFrame(column);
+    int last = column + 1 < _numColumns ? getFirstFrame(column + 1) : _numFrames;
+
+    float minError = 0.0f;
+    float maxError = 0.0f;
+    bool any = false;
+
+    for (int f = first; f < last; f++)
+        if (_hasError[f]) {
+            minError = any ? std::min(minError, _errors[f]) : _errors[f];
+            maxError = any ? std::max(maxError, _errors[f]) : _errors[f];
+            any = true;
+        }
+
+    sf::Color color = column <= _currentColumn ? _pastColor : _futureColor;
+    sf::Color rangeColor = color;
+    rangeColor.a = 96;
+
+    float left = _origin.x + _columnWidth * column;
+
+    int quad = _numGridLines + 1 + column * 2;
+
+    setQuad(quad, left, getY(minError), _columnWidth, _scaleY * minError, color);
+    setQuad(quad + 1, left, getY(maxError), _columnWidth, _scaleY * (maxError - minError), rangeColor);
+}
+
+void ErrorGraph::setError(int frame, float error) {
+    if (frame < 0 || frame >= _numFrames)
+        return;
+
+    if (_hasError[frame])
+        _errorTotal -= _errors[frame];
+    else
+        _errorCount++;
+
+    _errors[frame] = error;
+    _hasError[frame] = true;
+
+    _errorTotal += error;
+
+    markDirty(getColumn(frame));
+}
+
+void ErrorGraph::setCurrentFrame(int frame) {
+    int column = frame < 0 ? -1 : getColumn(std::min(frame, _numFrames - 1));
+
+    if (column == _currentColumn)
+        return;
+
+    // Recolour only the columns that switched between past and future
+    int from = std::min(column, _currentColumn) + 1;
+    int to = std::max(column, _currentColumn);
+
+    for (int c = std::max(0, from); c <= to && c < _numColumns; c++)
+        markDirty(c);
+
+    _currentColumn = column;
+}
+
+void ErrorGraph::draw(sf::RenderTarget &target) {
+    for (int c : _dirtyColumns) {
+        rebuildColumn(c);
+
+        _dirty[c] = false;
+    }
+
+    _dirtyColumns.clear();
+
+    // Horizontal average error line
+    setQuad(_numGridLines, _origin.x, getY(getAverageError()), getWidth(), 2.0f, _averageColor);
+
+    target.draw(_vertices);
+}
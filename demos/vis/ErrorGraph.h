@@ -0,0 +1,93 @@
+// ----------------------------------------------------------------------------
+//  OgmaNeoDemos
+//  Copyright(c) 2016 Ogma Intelligent Systems Corp. All rights reserved.
+//
+//  This copy of OgmaNeoDemos is licensed to you under the terms described
+//  in the OGMANEODEMOS_LICENSE.md file included in this distribution.
+// ----------------------------------------------------------------------------
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <vector>
+
+namespace vis {
+    // Per frame error bar graph, drawn as a single vertex array.
+    // Only columns whose errors (or past/future colouring) changed are rebuilt. When there are more
+    // frames than horizontal pixels, each pixel column shows the min and max error of its frames
+    class ErrorGraph {
+    private:
+        // Quads: grid lines, then the average line, then two per column (bar to min, min to max)
+        sf::VertexArray _vertices;
+
+        std::vector<float> _errors;
+        std::vector<bool> _hasError;
+
+        std::vector<bool> _dirty;
+        std::vector<int> _dirtyColumns;
+
+        int _numFrames;
+        int _numColumns;
+        int _numGridLines;
+
+        // Columns up to and including this one are drawn in the past colour
+        int _currentColumn;
+
+        // Double, so replacing errors frame after frame over many passes does not drift the average
+        double _errorTotal;
+        int _errorCount;
+
+        sf::Vector2f _origin;
+        float _columnWidth;
+        float _scaleY;
+        float _gridSpacing;
+
+        void setQuad(int quad, float left, float top, float width, float height, const sf::Color &color);
+        void markDirty(int column);
+        void rebuildColumn(int column);
+
+        int getColumn(int frame) const;
+
+        int getFirstFrame(int column) const {
+            return static_cast<int>(static_cast<long long>(column) * _numFrames / _numColumns);
+        }
+
+    public:
+        sf::Color _pastColor;
+        sf::Color _futureColor;
+        sf::Color _gridColor;
+        sf::Color _averageColor;
+
+        ErrorGraph()
+            : _numFrames(0), _numColumns(0), _numGridLines(0), _currentColumn(-1), _errorTotal(0.0), _errorCount(0),
+            _columnWidth(1.0f), _scaleY(1.0f), _gridSpacing(1.0f),
+            _pastColor(sf::Color::Red), _futureColor(sf::Color::Green), _gridColor(sf::Color::White), _averageColor(sf::Color::Yellow)
+        {}
+
+        // origin is the bottom left corner, bars are scaleX wide (narrower if the graph would exceed maxWidth)
+        // and scaleY high per unit of error. Grid lines are gridSpacing apart
+        void create(int numFrames, const sf::Vector2f &origin, float maxWidth, float scaleX, float scaleY, int numGridLines, float gridSpacing);
+
+        void setError(int frame, float error);
+
+        // Frames up to and including frame are drawn in the past colour
+        void setCurrentFrame(int frame);
+
+        // Mean of the errors set so far
+        float getAverageError() const {
+            return _errorCount > 0 ? static_cast<float>(_errorTotal / _errorCount) : 0.0f;
+        }
+
+        // Screen height of an error value
+        float getY(float error) const {
+            return _origin.y - _scaleY * error;
+        }
+
+        float getWidth() const {
+            return _columnWidth * _numColumns;
+        }
+
+        void draw(sf::RenderTarget &target);
+    };
+}